@@ -5,33 +5,538 @@
 #include <variant>
 #include <fstream>
 #include <sstream>
-#include <stdexcept> // For std::runtime_error in main for unhandled cases
 
 #include <cassert>
-#include <typeinfo>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <regex>
+#include <source_location>
+#include <stop_token>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+// POSIX APIs used to map compiled config images and to batch output writes.
+#include <fcntl.h>
+#include <linux/perf_event.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Stack capture on errors is opt-in because std::stacktrace still needs an
+// extra library at link time (-lstdc++exp on GCC 13+).
+#if defined(PIPELINE_ENABLE_STACKTRACE)
+#include <stacktrace>
+#endif
+
+// Sampled stack capture for pipeline errors.
+// Only every Nth error records a trace, and only the raw frame addresses are
+// kept; symbolization is deferred until the error is actually printed.
+// The error itself carries a small id into a bounded ring of captured traces,
+// so copying an error never copies a trace.
+struct CapturedStack {
+    std::uint32_t id = 0; // 0 means "not captured"
+
+    static CapturedStack sample();
+};
+
+// 0 disables capture, 1 captures every error, N captures every Nth error.
+inline std::atomic<std::uint32_t> g_stack_sample_period{0};
+inline std::atomic<std::uint32_t> g_stack_sample_counter{0};
+
+void set_stack_sample_period(std::uint32_t period) {
+    g_stack_sample_period.store(period, std::memory_order_relaxed);
+}
+
+#if defined(PIPELINE_ENABLE_STACKTRACE)
+class StackRegistry {
+public:
+    static constexpr std::size_t kSlots = 256;
+
+    std::uint32_t store(std::stacktrace trace) {
+        std::lock_guard lock(mutex_);
+        std::uint32_t id = ++last_id_;
+        if (id == 0) { // skip the "not captured" id on wrap-around
+            id = ++last_id_;
+        }
+        Slot& slot = slots_[id % kSlots];
+        slot.id = id;
+        slot.trace = std::move(trace);
+        return id;
+    }
+
+    // Symbolizes the trace; an evicted trace yields false.
+    bool print(std::uint32_t id, std::ostream& os) {
+        std::lock_guard lock(mutex_);
+        const Slot& slot = slots_[id % kSlots];
+        if (slot.id != id) {
+            return false;
+        }
+        os << slot.trace;
+        return true;
+    }
+
+private:
+    struct Slot {
+        std::uint32_t id = 0;
+        std::stacktrace trace;
+    };
+
+    std::mutex mutex_;
+    std::uint32_t last_id_ = 0;
+    std::array<Slot, kSlots> slots_;
+};
+
+inline StackRegistry g_stack_registry;
+#endif
+
+CapturedStack CapturedStack::sample() {
+#if defined(PIPELINE_ENABLE_STACKTRACE)
+    const std::uint32_t period = g_stack_sample_period.load(std::memory_order_relaxed);
+    if (period != 0 &&
+        g_stack_sample_counter.fetch_add(1, std::memory_order_relaxed) % period == 0) {
+        // Skip this frame so the trace starts at the error construction site.
+        return CapturedStack{g_stack_registry.store(std::stacktrace::current(1))};
+    }
+#endif
+    return CapturedStack{};
+}
+
+void print_captured_stack([[maybe_unused]] const CapturedStack& stack, [[maybe_unused]] std::ostream& os) {
+#if defined(PIPELINE_ENABLE_STACKTRACE)
+    if (stack.id == 0) {
+        return;
+    }
+    os << "Captured stack:\n";
+    if (!g_stack_registry.print(stack.id, os)) {
+        os << "  (evicted)";
+    }
+    os << std::endl;
+#endif
+}
+
+// Heap allocation accounting.
+// The global operator new/delete are replaced so tests and the fuzz harness
+// can count the allocations a region of code makes. Counters are per thread,
+// so work running on other threads does not leak into a measurement.
+struct AllocationStats {
+    std::uint64_t count = 0;
+    std::uint64_t bytes = 0;
+};
+
+inline thread_local AllocationStats t_allocation_stats;
+
+// Allocation failure handling.
+// With exceptions, a failed allocation throws std::bad_alloc as usual. Builds
+// with -fno-exceptions cannot throw, so the failed request is served from a
+// small emergency reserve instead and only recorded; guard_allocations()
+// then turns the record into an OutOfMemoryError at the stage boundary.
+// Requests larger than the reserve still terminate, with a message.
+inline thread_local std::size_t t_failed_allocation_size = 0;      // 0: no failure
+
+// The failure-injection hook is compiled only into test builds: those with
+// assertions enabled, or with -DPIPELINE_TESTING.
+#if !defined(NDEBUG) && !defined(PIPELINE_TESTING)
+#define PIPELINE_TESTING
+#endif
+#if defined(PIPELINE_TESTING)
+inline thread_local std::uint64_t t_fail_allocation_number = 0;   // 0: off
+#endif
+
+class EmergencyReserve {
+public:
+    static constexpr std::size_t kSize = 64 * 1024;
+
+    void* allocate(std::size_t size) {
+        const std::size_t rounded = (size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+        std::size_t offset = used_.load(std::memory_order_relaxed);
+        do {
+            if (rounded > kSize - offset) {
+                return nullptr;
+            }
+        } while (!used_.compare_exchange_weak(offset, offset + rounded, std::memory_order_relaxed));
+        return buffer_ + offset;
+    }
+
+    // Reserve memory is never returned; it only has to outlive the failing run.
+    bool owns(const void* p) const {
+        const auto* c = static_cast<const char*>(p);
+        return c >= buffer_ && c < buffer_ + kSize;
+    }
+
+private:
+    alignas(std::max_align_t) char buffer_[kSize];
+    std::atomic<std::size_t> used_{0};
+};
+
+inline EmergencyReserve g_emergency_reserve;
+
+void* try_allocate(std::size_t size) {
+    ++t_allocation_stats.count;
+    t_allocation_stats.bytes += size;
+#if defined(PIPELINE_TESTING)
+    if (t_fail_allocation_number != 0 && t_allocation_stats.count == t_fail_allocation_number) {
+        return nullptr;
+    }
+#endif
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+// noinline keeps GCC from pairing the inlined malloc/free with new/delete
+// expressions and reporting a bogus -Wmismatched-new-delete.
+[[gnu::noinline]] void* operator new(std::size_t size) {
+    if (void* p = try_allocate(size)) {
+        return p;
+    }
+    t_failed_allocation_size = size == 0 ? 1 : size;
+#if defined(__cpp_exceptions)
+    throw std::bad_alloc();
+#else
+    if (void* p = g_emergency_reserve.allocate(size)) {
+        return p;
+    }
+    // Nothing can be returned; say why without allocating, then abort.
+    char message[128];
+    const int length = std::snprintf(message, sizeof(message),
+                                     "out of memory: %zu-byte request exceeds the emergency reserve\n", size);
+    if (length > 0) {
+        static_cast<void>(::write(STDERR_FILENO, message, static_cast<std::size_t>(length)));
+    }
+    std::abort();
+#endif
+}
+
+[[gnu::noinline]] void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return try_allocate(size);
+}
+
+[[gnu::noinline]] void operator delete(void* p) noexcept {
+    if (!g_emergency_reserve.owns(p)) {
+        std::free(p);
+    }
+}
+
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept { ::operator delete(p); }
+[[gnu::noinline]] void operator delete(void* p, const std::nothrow_t&) noexcept { ::operator delete(p); }
+
+// Measures the allocations made on this thread between construction and stats().
+class AllocationScope {
+public:
+    AllocationScope() : start_(t_allocation_stats) {}
+
+    [[nodiscard]] AllocationStats stats() const {
+        return {t_allocation_stats.count - start_.count, t_allocation_stats.bytes - start_.bytes};
+    }
+
+private:
+    AllocationStats start_;
+};
+
+// Fixed-capacity string stored inline, so the error payloads stay trivially
+// copyable and building one never allocates. Longer text is cut at Capacity
+// bytes and truncated() remembers that it was.
+template<std::size_t Capacity>
+class InlineString {
+    static_assert(Capacity > 0 && Capacity <= 0xffff, "InlineString capacity must fit in 16 bits");
+
+public:
+    // Bytes past size() are left uninitialized at run time; constant
+    // evaluation requires every byte to be set.
+    constexpr InlineString() {
+        if consteval {
+            std::fill_n(data_, Capacity, '\0');
+        }
+    }
+    constexpr InlineString(std::string_view text) : InlineString() { assign(text); }
+    constexpr InlineString(const char* text) : InlineString(std::string_view(text)) {}
+    constexpr InlineString(const std::string& text) : InlineString(std::string_view(text)) {}
+
+    constexpr void assign(std::string_view text) {
+        truncated_ = text.size() > Capacity;
+        size_ = static_cast<std::uint16_t>(std::min(text.size(), Capacity));
+        std::copy_n(text.data(), size_, data_);
+    }
+
+    static constexpr std::size_t capacity() { return Capacity; }
+    constexpr std::size_t size() const { return size_; }
+    constexpr bool empty() const { return size_ == 0; }
+    constexpr bool truncated() const { return truncated_; }
+    constexpr const char* data() const { return data_; }
+    constexpr std::string_view view() const { return {data_, size_}; }
+    constexpr operator std::string_view() const { return view(); }
+
+    friend constexpr bool operator==(const InlineString& a, std::string_view b) { return a.view() == b; }
+    friend std::ostream& operator<<(std::ostream& os, const InlineString& s) { return os << s.view(); }
+
+private:
+    char data_[Capacity];
+    std::uint16_t size_ = 0;
+    bool truncated_ = false;
+};
+
+// Sized so each field, with its length and flag, fills a power-of-two block.
+using ErrorName = InlineString<60>;  // field and task names
+using ErrorText = InlineString<124>; // values, details, line excerpts
+using ErrorPath = InlineString<252>; // file names
+
+// Error context chains.
+// As an error travels back up the call chain, with_context records a frame
+// (stage, file, call site) for it in a per-thread arena, and the error keeps
+// only a handle to its newest frame. Frames are plain structs in a fixed
+// array, so the success path pays one branch and the error path allocates
+// nothing. A chain is readable on the thread that built it until a later run
+// on that thread records its first frame.
+struct ErrorContext {
+    std::uint32_t run = 0;  // 0: no frames
+    std::uint16_t head = 0; // 1-based index of the newest frame
+};
+
+struct ErrorContextFrame {
+    std::string_view stage; // always a string literal
+    std::uint16_t file_id;
+    std::uint16_t parent; // 1-based, 0 ends the chain
+    std::source_location where;
+};
+
+inline std::atomic<std::uint32_t> g_error_context_runs{0};
+
+class ErrorContextArena {
+public:
+    static constexpr std::size_t kMaxFrames = 64;
+    static constexpr std::size_t kMaxFiles = 8;
+    static constexpr std::uint16_t kNoFile = 0xffff;
+
+    // The previous run's frames stay readable until this run records one.
+    void begin_run() { fresh_ = true; }
+
+    // Returns the handle of a new frame on top of `context`. When the arena is
+    // full the frame is dropped and counted.
+    ErrorContext push(ErrorContext context, std::string_view stage, std::string_view file, std::source_location where) {
+        if (fresh_) {
+            fresh_ = false;
+            run_ = g_error_context_runs.fetch_add(1, std::memory_order_relaxed) + 1;
+            frame_count_ = file_count_ = 0;
+            dropped_ = 0;
+        }
+        if (context.run != run_) {
+            context = {}; // built by another run or thread
+        }
+        if (frame_count_ == kMaxFrames) {
+            ++dropped_;
+            return context;
+        }
+        frames_[frame_count_] = {stage, intern_file(file), context.head, where};
+        return {run_, static_cast<std::uint16_t>(++frame_count_)};
+    }
+
+    // Calls fn(frame, file) from the oldest frame (where the error was first
+    // seen) to the newest. Returns the number of frames dropped in this run,
+    // or nullopt when the chain is gone.
+    template<class F>
+    std::optional<std::size_t> for_each(ErrorContext context, F&& fn) const {
+        if (context.run == 0 || context.run != run_) {
+            return std::nullopt;
+        }
+        std::array<std::uint16_t, kMaxFrames> chain;
+        std::size_t length = 0;
+        for (std::uint16_t i = context.head; i != 0; i = frames_[i - 1].parent) {
+            chain[length++] = i;
+        }
+        while (length > 0) {
+            const ErrorContextFrame& frame = frames_[chain[--length] - 1];
+            fn(frame, frame.file_id == kNoFile ? std::string_view{} : files_[frame.file_id].view());
+        }
+        return dropped_;
+    }
+
+private:
+    std::uint16_t intern_file(std::string_view file) {
+        for (std::uint16_t i = 0; i < file_count_; ++i) {
+            if (files_[i] == file) {
+                return i;
+            }
+        }
+        if (file.empty() || file_count_ == kMaxFiles) {
+            return kNoFile;
+        }
+        files_[file_count_] = file;
+        return file_count_++;
+    }
+
+    std::array<ErrorContextFrame, kMaxFrames> frames_{};
+    std::array<ErrorPath, kMaxFiles> files_{};
+    std::uint32_t run_ = 0;
+    std::uint16_t frame_count_ = 0;
+    std::uint16_t file_count_ = 0;
+    std::size_t dropped_ = 0;
+    bool fresh_ = true;
+};
+
+inline thread_local ErrorContextArena t_error_context;
 
 // Step 1: Define Custom Error Types
 struct ConfigReadError {
-    std::string filename;
+    ErrorPath filename;
+    CapturedStack stack = CapturedStack::sample();
+    ErrorContext context{};
 };
 
 struct ConfigParseError {
-    std::string line_content;
+    ErrorText line_content;
     int line_number;
+    CapturedStack stack = CapturedStack::sample();
+    ErrorContext context{};
 };
 
 struct ValidationError {
-    std::string field_name;
-    std::string invalid_value;
+    ErrorName field_name;
+    ErrorText invalid_value;
+    std::size_t offset = std::string::npos; // where in the config, if known
+    CapturedStack stack = CapturedStack::sample();
+    ErrorContext context{};
 };
 
 struct ProcessingError {
-    std::string task_name;
-    std::string details;
+    ErrorName task_name;
+    ErrorText details;
+    CapturedStack stack = CapturedStack::sample();
+    ErrorContext context{};
+};
+
+struct OutOfMemoryError {
+    std::string_view stage; // always a string literal
+    std::size_t requested_bytes;
+    CapturedStack stack = CapturedStack::sample();
+    ErrorContext context{};
+};
+
+// A stop was requested through the run's std::stop_token.
+struct Cancelled {
+    std::string_view stage; // always a string literal
+    CapturedStack stack = CapturedStack::sample();
+    ErrorContext context{};
+};
+
+// A stage went past its own latency budget or past the run's total budget.
+struct DeadlineExceeded {
+    std::string_view stage; // always a string literal
+    std::chrono::nanoseconds budget;
+    std::chrono::nanoseconds overrun; // time spent past the deadline
+    bool run_budget;                  // the run's total budget, not the stage's
+    CapturedStack stack = CapturedStack::sample();
+    ErrorContext context{};
 };
 
 // Step 2: Define a Global Error Variant for the entire pipeline
-using PipelineError = std::variant<ConfigReadError, ConfigParseError, ValidationError, ProcessingError>;
+using PipelineError = std::variant<ConfigReadError, ConfigParseError, ValidationError, ProcessingError, OutOfMemoryError, Cancelled, DeadlineExceeded>;
+
+// No alternative owns heap memory: errors are copied with memcpy and creating
+// one cannot fail, even while reporting an allocation failure.
+static_assert(std::is_trivially_copyable_v<PipelineError>);
+
+// Adds a context frame to the error in `result`; a value passes through.
+template<class T>
+[[nodiscard]] std::expected<T, PipelineError> with_context(std::expected<T, PipelineError> result, std::string_view stage,
+                                                          std::string_view file = {},
+                                                          std::source_location where = std::source_location::current()) {
+    if (!result) [[unlikely]] {
+        std::visit([&](auto& e) { e.context = t_error_context.push(e.context, stage, file, where); }, result.error());
+    }
+    return result;
+}
+
+// Latency budgets for call_pipeline; kUnlimited disables a budget.
+struct PipelineBudget {
+    static constexpr std::chrono::nanoseconds kUnlimited = std::chrono::nanoseconds::max();
+
+    std::chrono::nanoseconds total = kUnlimited;
+    std::chrono::nanoseconds load = kUnlimited; // LoadConfig, including parsing
+    std::chrono::nanoseconds validate = kUnlimited;
+    std::chrono::nanoseconds process = kUnlimited;
+};
+
+// What may end a stage early: a stop request and a deadline on the monotonic
+// clock. Long scans call expired() once per kCancelCheckBytes block; the
+// clock is read only when a budget is set (a vDSO call, about 20 ns).
+class RunLimit {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    RunLimit() = default;
+    RunLimit(std::stop_token stop) : stop_(std::move(stop)) {}
+
+    // The limit of a stage starting now, in a run that started at `run_start`.
+    RunLimit(std::stop_token stop, Clock::time_point run_start, const PipelineBudget& budget,
+             std::chrono::nanoseconds stage_budget)
+        : stop_(std::move(stop)) {
+        if (stage_budget != PipelineBudget::kUnlimited) {
+            set_deadline(Clock::now() + stage_budget, stage_budget, false);
+        }
+        if (budget.total != PipelineBudget::kUnlimited) {
+            set_deadline(run_start + budget.total, budget.total, true);
+        }
+    }
+
+    [[nodiscard]] bool expired() const {
+        return stop_.stop_requested() || (has_deadline_ && Clock::now() >= deadline_);
+    }
+
+    // The error for an expired limit: Cancelled wins over DeadlineExceeded.
+    [[nodiscard]] PipelineError error(std::string_view stage) const {
+        if (stop_.stop_requested()) {
+            return Cancelled{stage};
+        }
+        const auto overrun = std::max(Clock::now() - deadline_, Clock::duration::zero());
+        return DeadlineExceeded{stage, budget_, std::chrono::duration_cast<std::chrono::nanoseconds>(overrun), run_budget_};
+    }
+
+private:
+    void set_deadline(Clock::time_point deadline, std::chrono::nanoseconds budget, bool run_budget) {
+        if (!has_deadline_ || deadline < deadline_) {
+            has_deadline_ = true;
+            deadline_ = deadline;
+            budget_ = budget;
+            run_budget_ = run_budget;
+        }
+    }
+
+    std::stop_token stop_;
+    bool has_deadline_ = false;
+    bool run_budget_ = false;
+    Clock::time_point deadline_{};
+    std::chrono::nanoseconds budget_{};
+};
 
 // Helper for overloaded lambdas (C++17 style)
 template<class... Ts>
@@ -55,104 +560,5330 @@ struct Result {
     int final_result_code;
 };
 
-// Step 3: Implement Functions Returning std::expected with PipelineError
-[[nodiscard]] std::expected<Config, PipelineError> LoadConfig(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "DEBUG: LoadConfig failed to open " << filename << std::endl;
-        return std::unexpected(ConfigReadError{filename});
+// DEBUG tracing from the stages; harnesses that run the pipeline millions of
+// times (fuzzing, benchmarks) switch it off.
+inline std::atomic<bool> g_debug_logging{true};
+
+bool debug_logging_enabled() {
+    return g_debug_logging.load(std::memory_order_relaxed);
+}
+
+// Intra-file parallel scanning for huge configs.
+// The buffer is split into one chunk per thread, with every cut placed just
+// after a newline. A pattern without newlines can then never straddle two
+// chunks, and the first hit of the lowest chunk (and so the lowest line
+// number) is exactly what a sequential scan would return. Threads skip work
+// once a hit in an earlier chunk is known.
+inline constexpr std::size_t kParallelScanThreshold = std::size_t{1} << 20;
+inline constexpr unsigned kMaxScanThreads = 16;
+
+// hardware_concurrency() reads sysfs on glibc, too slow to call per scan.
+inline unsigned default_scan_threads() {
+    static const unsigned threads = std::thread::hardware_concurrency();
+    return threads;
+}
+// Long scans check their RunLimit once per block of this many bytes, which
+// bounds the reaction to a stop request or deadline to well under a millisecond.
+inline constexpr std::size_t kCancelCheckBytes = std::size_t{64} << 10;
+
+struct ScanHit {
+    std::size_t offset = std::string_view::npos;
+    std::uint32_t rule = 0; // which pattern matched, for multi-pattern scans
+};
+
+// `finder` scans one chunk and returns its first hit relative to the chunk.
+template<class Finder>
+[[nodiscard]] ScanHit find_first_parallel(std::string_view data, unsigned max_threads, Finder finder) {
+    const unsigned threads = std::clamp(max_threads, 1u, kMaxScanThreads);
+    if (threads == 1) {
+        return finder(data);
     }
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    std::string content = buffer.str();
 
-    // Simulate a parse error for empty config or specific content
-    if (content.empty() || content.find("malformed") != std::string::npos) {
-        std::cerr << "DEBUG: LoadConfig detected malformed config in " << filename << std::endl;
-        return std::unexpected(ConfigParseError{"malformed", 1});
+    std::vector<std::size_t> cuts = {0};
+    const std::size_t target = data.size() / threads;
+    for (unsigned k = 1; k < threads; ++k) {
+        const std::size_t nl = data.find('\n', std::max(k * target, cuts.back()));
+        if (nl == std::string_view::npos) {
+            break;
+        }
+        cuts.push_back(nl + 1);
+    }
+    cuts.push_back(data.size());
+
+    std::vector<ScanHit> hits(cuts.size() - 1);
+    std::atomic<std::size_t> best{std::string_view::npos};
+    {
+        std::vector<std::jthread> workers;
+        for (std::size_t c = 0; c + 1 < cuts.size(); ++c) {
+            workers.emplace_back([&, c, begin = cuts[c], end = cuts[c + 1]] {
+                if (begin >= best.load(std::memory_order_relaxed)) {
+                    return;
+                }
+                ScanHit hit = finder(data.substr(begin, end - begin));
+                if (hit.offset == std::string_view::npos) {
+                    return;
+                }
+                hit.offset += begin;
+                hits[c] = hit;
+                std::size_t current = best.load(std::memory_order_relaxed);
+                while (hit.offset < current && !best.compare_exchange_weak(current, hit.offset, std::memory_order_relaxed)) {
+                }
+            });
+        }
+    }
+    for (const ScanHit& hit : hits) {
+        if (hit.offset != std::string_view::npos) {
+            return hit;
+        }
     }
-    std::cout << "DEBUG: Config loaded successfully from " << filename << std::endl;
-    return Config{content};
+    return {};
 }
 
-[[nodiscard]] std::expected<ValidatedData, PipelineError> ValidateData(const Config& config) {
-    // Simulate a validation error
-    if (config.data.find("invalid_field") != std::string::npos) {
-        std::cerr << "DEBUG: ValidateData detected invalid field." << std::endl;
-        return std::unexpected(ValidationError{"invalid_field", "contains disallowed value"});
+// text.find(token), checking `limit` between blocks; nullopt once it expired.
+[[nodiscard]] std::optional<std::size_t> find_token_limited(std::string_view text, std::string_view token,
+                                                            const RunLimit& limit) {
+    if (token.empty()) {
+        return 0;
     }
-    std::cout << "DEBUG: Data validated successfully." << std::endl;
-    return ValidatedData{"Validated: " + config.data};
+    for (std::size_t block = 0; block < text.size(); block += kCancelCheckBytes) {
+        if (limit.expired()) {
+            return std::nullopt;
+        }
+        // Extend the window so a match straddling the block end is found here.
+        const std::size_t end = std::min(text.size(), block + kCancelCheckBytes + token.size() - 1);
+        if (const std::size_t pos = text.substr(0, end).find(token, block); pos != std::string_view::npos) {
+            return pos;
+        }
+    }
+    return std::string_view::npos;
 }
 
-[[nodiscard]] std::expected<Result, PipelineError> ProcessData(const ValidatedData& data) {
-    // Simulate a processing error
-    if (data.processed_data.length() < 10) {
-        std::cerr << "DEBUG: ProcessData detected data too short." << std::endl;
-        return std::unexpected(ProcessingError{"Data Processing", "Input data too short for task"});
+// Multi-pattern forbidden-token rules.
+// The pattern set is compiled once into an Aho-Corasick automaton and each
+// config is scanned in a single pass, however many patterns there are. The
+// automaton is stored as a dense DFA over byte classes: bytes that occur in
+// no pattern share class 0, so a row has only (distinct pattern bytes + 1)
+// entries and the whole table stays small enough to live in cache.
+class PatternRuleEngine {
+public:
+    struct Rule {
+        std::string pattern;
+        std::string field_name;    // reported as ValidationError::field_name
+        std::string invalid_value; // reported as ValidationError::invalid_value
+    };
+
+    struct Match {
+        std::uint32_t rule;
+        std::size_t offset; // start of the match in the scanned text
+    };
+
+    // Empty patterns are ignored.
+    [[nodiscard]] static PatternRuleEngine compile(std::vector<Rule> rules) {
+        PatternRuleEngine engine;
+        engine.rules_ = std::move(rules);
+
+        engine.byte_class_.fill(0);
+        std::uint32_t classes = 1;
+        for (const Rule& rule : engine.rules_) {
+            for (unsigned char c : rule.pattern) {
+                if (engine.byte_class_[c] == 0) {
+                    engine.byte_class_[c] = static_cast<std::uint16_t>(classes++);
+                }
+            }
+            engine.spans_newline_ |= rule.pattern.find('\n') != std::string::npos;
+        }
+        engine.classes_ = classes;
+
+        // Build the trie; -1 marks a missing edge until the DFA is completed.
+        std::vector<std::int32_t> trie(classes, -1);
+        std::vector<std::uint32_t> pattern_length = {0};
+        std::vector<std::vector<std::uint32_t>> outputs(1);
+        for (std::uint32_t r = 0; r < engine.rules_.size(); ++r) {
+            const std::string& pattern = engine.rules_[r].pattern;
+            if (pattern.empty()) {
+                continue;
+            }
+            std::uint32_t state = 0;
+            for (unsigned char c : pattern) {
+                std::int32_t& edge = trie[state * classes + engine.byte_class_[c]];
+                if (edge < 0) {
+                    edge = static_cast<std::int32_t>(outputs.size());
+                    trie.resize(trie.size() + classes, -1);
+                    outputs.emplace_back();
+                    pattern_length.push_back(pattern_length[state] + 1);
+                }
+                state = static_cast<std::uint32_t>(trie[state * classes + engine.byte_class_[c]]);
+            }
+            outputs[state].push_back(r);
+        }
+
+        // Breadth-first: fill failure transitions and merge suffix outputs.
+        const std::size_t states = outputs.size();
+        engine.next_.assign(states * classes, 0);
+        std::vector<std::uint32_t> fail(states, 0);
+        std::vector<std::uint32_t> queue;
+        for (std::uint32_t c = 0; c < classes; ++c) {
+            if (trie[c] > 0) {
+                engine.next_[c] = static_cast<std::uint32_t>(trie[c]);
+                queue.push_back(static_cast<std::uint32_t>(trie[c]));
+            }
+        }
+        for (std::size_t head = 0; head < queue.size(); ++head) {
+            const std::uint32_t state = queue[head];
+            const auto& suffix_outputs = outputs[fail[state]];
+            outputs[state].insert(outputs[state].end(), suffix_outputs.begin(), suffix_outputs.end());
+            for (std::uint32_t c = 0; c < classes; ++c) {
+                const std::int32_t child = trie[state * classes + c];
+                if (child >= 0) {
+                    fail[child] = engine.next_[fail[state] * classes + c];
+                    engine.next_[state * classes + c] = static_cast<std::uint32_t>(child);
+                    queue.push_back(static_cast<std::uint32_t>(child));
+                } else {
+                    engine.next_[state * classes + c] = engine.next_[fail[state] * classes + c];
+                }
+            }
+        }
+
+        // Flatten outputs; the first output of a state is its longest pattern,
+        // i.e. the match that starts earliest.
+        engine.output_begin_.reserve(states + 1);
+        for (auto& out : outputs) {
+            std::stable_sort(out.begin(), out.end(), [&engine](std::uint32_t a, std::uint32_t b) {
+                return engine.rules_[a].pattern.size() > engine.rules_[b].pattern.size();
+            });
+            engine.output_begin_.push_back(static_cast<std::uint32_t>(engine.outputs_.size()));
+            engine.outputs_.insert(engine.outputs_.end(), out.begin(), out.end());
+        }
+        engine.output_begin_.push_back(static_cast<std::uint32_t>(engine.outputs_.size()));
+        return engine;
     }
-    std::cout << "DEBUG: Data processed successfully." << std::endl;
-    return Result{static_cast<int>(data.processed_data.length())};
+
+    // Calls f(Match) for every occurrence of every pattern, in order of the
+    // match end.
+    template<class F>
+    void for_each_match(std::string_view text, F&& f) const {
+        std::uint32_t state = 0;
+        for (std::size_t i = 0; i < text.size(); ++i) {
+            state = step(state, text[i]);
+            for (std::uint32_t o = output_begin_[state]; o < output_begin_[state + 1]; ++o) {
+                const std::uint32_t rule = outputs_[o];
+                f(Match{rule, i + 1 - rules_[rule].pattern.size()});
+            }
+        }
+    }
+
+    // The earliest-ending match; huge texts are scanned in parallel chunks
+    // when no pattern contains a newline. An expired limit ends the scan within
+    // kCancelCheckBytes; the result is then meaningless and callers check
+    // `limit` themselves.
+    [[nodiscard]] std::optional<Match> find_first(std::string_view text,
+                                                  unsigned max_threads = default_scan_threads(),
+                                                  const RunLimit& limit = {}) const {
+        const auto scan = [this, &limit](std::string_view chunk) {
+            std::uint32_t state = 0;
+            for (std::size_t block = 0; block < chunk.size(); block += kCancelCheckBytes) {
+                if (limit.expired()) {
+                    break;
+                }
+                const std::size_t end = std::min(chunk.size(), block + kCancelCheckBytes);
+                for (std::size_t i = block; i < end; ++i) {
+                    state = step(state, chunk[i]);
+                    if (output_begin_[state] != output_begin_[state + 1]) {
+                        const std::uint32_t rule = outputs_[output_begin_[state]];
+                        return ScanHit{i + 1 - rules_[rule].pattern.size(), rule};
+                    }
+                }
+            }
+            return ScanHit{};
+        };
+        const ScanHit hit = text.size() < kParallelScanThreshold || spans_newline_
+                                ? scan(text)
+                                : find_first_parallel(text, max_threads, scan);
+        if (hit.offset == std::string_view::npos) {
+            return std::nullopt;
+        }
+        return Match{hit.rule, hit.offset};
+    }
+
+    [[nodiscard]] ValidationError make_error(const Match& match) const {
+        const Rule& rule = rules_[match.rule];
+        return ValidationError{rule.field_name, rule.invalid_value, match.offset};
+    }
+
+    const Rule& rule(std::uint32_t index) const { return rules_[index]; }
+    std::size_t state_count() const { return output_begin_.size() - 1; }
+
+private:
+    std::uint32_t step(std::uint32_t state, char c) const {
+        return next_[state * classes_ + byte_class_[static_cast<unsigned char>(c)]];
+    }
+
+    std::vector<Rule> rules_;
+    std::array<std::uint16_t, 256> byte_class_{};
+    std::uint32_t classes_ = 1;
+    bool spans_newline_ = false;
+    std::vector<std::uint32_t> next_;         // state * classes_ + class -> state
+    std::vector<std::uint32_t> output_begin_; // state -> first index into outputs_
+    std::vector<std::uint32_t> outputs_;      // rule ids
+};
+
+// Runs `fn` and reports an allocation failure inside it as OutOfMemoryError,
+// both when std::bad_alloc is thrown and, in -fno-exceptions builds, when
+// operator new fell back to the emergency reserve.
+template<class Fn>
+[[nodiscard]] auto guard_allocations(std::string_view stage, Fn&& fn) -> std::invoke_result_t<Fn> {
+    t_failed_allocation_size = 0;
+#if defined(__cpp_exceptions)
+    try {
+        return std::forward<Fn>(fn)();
+    } catch (const std::bad_alloc&) {
+        const std::size_t failed = std::exchange(t_failed_allocation_size, 0);
+        return std::unexpected(OutOfMemoryError{stage, failed});
+    }
+#else
+    auto result = std::forward<Fn>(fn)();
+    if (const std::size_t failed = std::exchange(t_failed_allocation_size, 0); failed != 0) {
+        return std::unexpected(OutOfMemoryError{stage, failed});
+    }
+    return result;
+#endif
 }
 
-// Step 5: Handling the Final Result with std::visit
-void handle_pipeline_result(const std::expected<Result, PipelineError>& final_result) {
-    if (final_result) {
-        std::cout << "\nPipeline Succeeded! Final Result Code: " << final_result->final_result_code << std::endl;
-    } else {
-        std::cerr << "\nPipeline Failed! Error details: ";
-        std::visit(Overloaded {
-            [](const ConfigReadError& e) {
-                std::cerr << "Configuration Read Error: Could not open file '" << e.filename << "'" << std::endl;
-            },
-            [](const ConfigParseError& e) {
-                std::cerr << "Configuration Parse Error: Malformed content at line "
-                          << e.line_number << " (Context: '" << e.line_content << "')" << std::endl;
-            },
-            [](const ValidationError& e) {
-                std::cerr << "Data Validation Error: Field '" << e.field_name
-                          << "' has invalid value '" << e.invalid_value << "'" << std::endl;
-            },
-            [](const ProcessingError& e) {
-                std::cerr << "Data Processing Error: Task '" << e.task_name
-                          << "' failed. Details: " << e.details << std::endl;
-            },
-            // This generic lambda serves as a fallback for any unhandled types.
-            // For strict compile-time enforcement of exhaustiveness, a static_assert(false,...)
-            // could be used here if all types are expected to be handled.
-            [](auto&& arg) {
-                // This branch should ideally not be reachable if all specific error types are handled.
-                // In a production system, this might log an unexpected error type.
-                std::cerr << "An unexpected error type was encountered." << std::endl;
+// The rules the stages enforce, shared by the runtime and constexpr paths.
+inline constexpr std::string_view kMalformedMarker = "malformed";
+inline constexpr std::string_view kForbiddenField = "invalid_field";
+inline constexpr std::string_view kValidatedPrefix = "Validated: ";
+inline constexpr std::size_t kMinProcessedLength = 10;
+
+// The built-in ValidateData rules. Both the runtime automaton and the
+// constexpr stage are built from this table, so they cannot drift apart.
+struct DefaultRule {
+    std::string_view pattern;
+    std::string_view field_name;
+    std::string_view invalid_value;
+};
+
+inline constexpr DefaultRule kDefaultRules[] = {
+    {kForbiddenField, "invalid_field", "contains disallowed value"},
+};
+
+// PipelineError alternatives by name, for code that cannot hold a PipelineError
+// (e.g. constant evaluation). The values are the variant indices.
+enum class PipelineErrorKind : std::uint8_t {
+    ConfigRead,
+    ConfigParse,
+    Validation,
+    Processing,
+    OutOfMemory,
+    Cancelled,
+    DeadlineExceeded,
+};
+
+static_assert(std::variant_size_v<PipelineError> == 7, "update PipelineErrorKind together with PipelineError");
+static_assert(std::is_same_v<std::variant_alternative_t<static_cast<std::size_t>(PipelineErrorKind::Validation), PipelineError>,
+                             ValidationError>);
+
+// Error domains.
+// Each PipelineError alternative has a stable numeric code (never renumbered
+// or reused; new alternatives take the next free code) and fixed properties
+// in kErrorTraits, indexed by the variant index. Classifying an error is then
+// a table load instead of a std::visit. The codes form the "pipeline"
+// std::error_category, so pipeline errors mix with errno codes and with other
+// domains in one std::error_code, and map onto std::errc where one fits.
+enum class ErrorSeverity : std::uint8_t {
+    Info,  // the caller asked for it, e.g. cancellation
+    Error, // this input failed
+    Fatal, // the process is in trouble
+};
+
+struct ErrorTraits {
+    int code;
+    std::string_view name;
+    ErrorSeverity severity;
+    bool retryable;          // the same input may succeed on another attempt
+    bool deterministic;      // the same input always gives the same error
+    std::string_view stage;  // reporting stage; empty when the error names it
+    std::errc generic = {};  // std::errc{} when none fits
+};
+
+inline constexpr std::array<ErrorTraits, std::variant_size_v<PipelineError>> kErrorTraits = {{
+    {1, "ConfigReadError", ErrorSeverity::Error, true, false, "LoadConfig", std::errc::io_error},
+    {2, "ConfigParseError", ErrorSeverity::Error, false, true, "ParseConfig"},
+    {3, "ValidationError", ErrorSeverity::Error, false, true, "ValidateData", std::errc::invalid_argument},
+    {4, "ProcessingError", ErrorSeverity::Error, false, true, "ProcessData"},
+    {5, "OutOfMemoryError", ErrorSeverity::Fatal, true, false, "", std::errc::not_enough_memory},
+    {6, "Cancelled", ErrorSeverity::Info, false, false, "", std::errc::operation_canceled},
+    {7, "DeadlineExceeded", ErrorSeverity::Error, true, false, "", std::errc::timed_out},
+}};
+
+static_assert([] {
+    for (std::size_t i = 0; i < kErrorTraits.size(); ++i) {
+        for (std::size_t j = 0; j < i; ++j) {
+            if (kErrorTraits[i].code == kErrorTraits[j].code) {
+                return false;
             }
-        }, final_result.error());
+        }
+        if (kErrorTraits[i].code <= 0 || kErrorTraits[i].code > 0xff) {
+            return false;
+        }
     }
+    return true;
+}(), "error codes must be unique, non-zero (0 means success in std::error_code) and fit the binary tag byte");
+
+[[nodiscard]] constexpr const ErrorTraits& error_traits(PipelineErrorKind kind) {
+    return kErrorTraits[static_cast<std::size_t>(kind)];
 }
 
-// A helper function for unit tests calling pipeline.
-[[nodiscard]] std::expected<Result, PipelineError> call_pipeline(const std::string &configfile) {
-    return LoadConfig(configfile)
-       .and_then([](const Config& cfg) { return ValidateData(cfg); })
-       .and_then([](const ValidatedData& vd) { return ProcessData(vd); });
+[[nodiscard]] constexpr const ErrorTraits& error_traits(const PipelineError& error) {
+    return kErrorTraits[error.index()];
 }
 
-void test_read_nonexisted_config_file() {
-    const std::string filename = "this_file_should_not_exist.txt";
-    ConfigReadError expected = {
-        .filename = filename,
-    };
-    auto ret = call_pipeline(filename);
+[[nodiscard]] constexpr PipelineErrorKind error_kind(const PipelineError& error) {
+    return static_cast<PipelineErrorKind>(error.index());
+}
 
-    assert(ret.has_value() == false);
-    auto target = ret.error();
-    ConfigReadError *c = std::get_if<ConfigReadError>(&target);
-    assert(c != nullptr);
-    assert(c->filename == expected.filename);
+// The kind with the given stable code, e.g. one read back from disk.
+[[nodiscard]] constexpr std::optional<PipelineErrorKind> error_kind_from_code(int code) {
+    for (std::size_t i = 0; i < kErrorTraits.size(); ++i) {
+        if (kErrorTraits[i].code == code) {
+            return static_cast<PipelineErrorKind>(i);
+        }
+    }
+    return std::nullopt;
+}
 
-    std::cout << "test_read_nonexisted_config_file() passes" << std::endl;
+[[nodiscard]] constexpr bool is_retryable(const PipelineError& error) {
+    return error_traits(error).retryable;
+}
+
+class PipelineErrorCategory final : public std::error_category {
+public:
+    const char* name() const noexcept override { return "pipeline"; }
+
+    std::string message(int code) const override {
+        const ErrorTraits* traits = find(code);
+        return traits ? std::string(traits->name) : "unknown pipeline error";
+    }
+
+    std::error_condition default_error_condition(int code) const noexcept override {
+        const ErrorTraits* traits = find(code);
+        if (traits && traits->generic != std::errc{}) {
+            return std::make_error_condition(traits->generic);
+        }
+        return std::error_condition(code, *this);
+    }
+
+private:
+    static const ErrorTraits* find(int code) {
+        const auto it = std::find_if(kErrorTraits.begin(), kErrorTraits.end(),
+                                     [code](const ErrorTraits& t) { return t.code == code; });
+        return it == kErrorTraits.end() ? nullptr : &*it;
+    }
+};
+
+const std::error_category& pipeline_error_category() {
+    static const PipelineErrorCategory category;
+    return category;
+}
+
+std::error_code make_error_code(PipelineErrorKind kind) {
+    return {error_traits(kind).code, pipeline_error_category()};
+}
+
+std::error_code make_error_code(const PipelineError& error) {
+    return {error_traits(error).code, pipeline_error_category()};
+}
+
+template<>
+struct std::is_error_code_enum<PipelineErrorKind> : std::true_type {};
+
+// Compile-time evaluable stages.
+// They mirror ParseConfig / ValidateData / ProcessData on a string_view and
+// never materialize the validated payload, so a config embedded in the
+// binary can be checked entirely during compilation.
+struct ValidatedView {
+    std::string_view data; // the validated payload is kValidatedPrefix + data
+    constexpr std::size_t processed_length() const { return kValidatedPrefix.size() + data.size(); }
+};
+
+[[nodiscard]] constexpr std::expected<std::string_view, PipelineErrorKind> ParseConfigConstexpr(std::string_view content) {
+    if (content.empty() || content.find(kMalformedMarker) != std::string_view::npos) {
+        return std::unexpected(PipelineErrorKind::ConfigParse);
+    }
+    return content;
+}
+
+[[nodiscard]] constexpr std::expected<ValidatedView, PipelineErrorKind> ValidateDataConstexpr(std::string_view data) {
+    for (const DefaultRule& rule : kDefaultRules) {
+        if (data.find(rule.pattern) != std::string_view::npos) {
+            return std::unexpected(PipelineErrorKind::Validation);
+        }
+    }
+    return ValidatedView{data};
+}
+
+[[nodiscard]] constexpr std::expected<Result, PipelineErrorKind> ProcessDataConstexpr(ValidatedView data) {
+    if (data.processed_length() < kMinProcessedLength) {
+        return std::unexpected(PipelineErrorKind::Processing);
+    }
+    return Result{static_cast<int>(data.processed_length())};
+}
+
+[[nodiscard]] constexpr std::expected<Result, PipelineErrorKind> call_pipeline_constexpr(std::string_view content) {
+    return ParseConfigConstexpr(content)
+       .and_then([](std::string_view data) { return ValidateDataConstexpr(data); })
+       .and_then([](ValidatedView vd) { return ProcessDataConstexpr(vd); });
+}
+
+// A string literal usable as a template argument: embedded config text,
+// regex patterns and schema keys.
+template<std::size_t N>
+struct FixedString {
+    char text[N]{};
+
+    consteval FixedString(const char (&literal)[N]) {
+        std::copy_n(literal, N, text);
+    }
+
+    constexpr std::string_view view() const { return {text, N - 1}; }
+};
+
+// Instantiated only for a rejected embedded config, so the compiler error
+// names the PipelineError alternative, e.g. EmbeddedConfigRejected<ValidationError>.
+template<class Error>
+struct EmbeddedConfigRejected {
+    static_assert(!std::is_same_v<Error, Error>, "embedded config fails the pipeline; see the template argument");
+};
+
+// Runs the whole pipeline at compile time on the text returned by `View`
+// (a captureless callable) and yields its Result; no validation is left for
+// run time.
+template<auto View>
+consteval Result validate_embedded_text() {
+    constexpr auto result = call_pipeline_constexpr(View());
+    if constexpr (!result.has_value()) {
+        using Error = std::variant_alternative_t<static_cast<std::size_t>(result.error()), PipelineError>;
+        static_cast<void>(EmbeddedConfigRejected<Error>{});
+        return Result{0};
+    } else {
+        return *result;
+    }
+}
+
+template<FixedString Text>
+consteval Result validate_embedded_config() {
+    return validate_embedded_text<[] { return Text.view(); }>();
 }
 
-int main() {
+// The built-in rule set used by ValidateData(const Config&).
+const PatternRuleEngine& default_rule_engine() {
+    static const PatternRuleEngine engine = [] {
+        std::vector<PatternRuleEngine::Rule> rules;
+        for (const DefaultRule& rule : kDefaultRules) {
+            rules.push_back({std::string(rule.pattern), std::string(rule.field_name), std::string(rule.invalid_value)});
+        }
+        return PatternRuleEngine::compile(std::move(rules));
+    }();
+    return engine;
+}
+
+// Compile-time regular expression rules.
+// A pattern given as a template argument is parsed during compilation into a
+// small backtracking program, and the matcher is instantiated per
+// instruction, so every rule becomes straight-line specialized code: no
+// regex compilation at run time and no allocation while matching. Supported
+// syntax: literals, '.', classes ([a-z], [^...]), \d \w \s (and \D \W \S),
+// groups, '|', '*', '+', '?', and the line anchors '^' and '$'. A syntax error
+// is a compile error.
+struct ByteSet {
+    std::array<std::uint64_t, 4> bits{};
+
+    constexpr void add(unsigned char c) { bits[c >> 6] |= std::uint64_t{1} << (c & 63); }
+    constexpr void add_range(unsigned char first, unsigned char last) {
+        for (unsigned c = first; c <= last; ++c) {
+            add(static_cast<unsigned char>(c));
+        }
+    }
+    constexpr void merge(const ByteSet& other) {
+        for (std::size_t i = 0; i < bits.size(); ++i) {
+            bits[i] |= other.bits[i];
+        }
+    }
+    constexpr void invert() {
+        for (auto& word : bits) {
+            word = ~word;
+        }
+    }
+    constexpr bool test(unsigned char c) const { return (bits[c >> 6] >> (c & 63)) & 1; }
+
+    // The only member, or -1 if the set does not hold exactly one byte.
+    constexpr int single() const {
+        int found = -1;
+        for (unsigned c = 0; c < 256; ++c) {
+            if (test(static_cast<unsigned char>(c))) {
+                if (found >= 0) {
+                    return -1;
+                }
+                found = static_cast<int>(c);
+            }
+        }
+        return found;
+    }
+};
+
+enum class RegexOp : std::uint8_t {
+    Class,     // one byte in `set`, then `next`
+    StarClass, // greedy run of bytes in `set`, then `next`
+    Split,     // try `next`, then `alt`
+    LineStart,
+    LineEnd,
+    Match,
+};
+
+struct RegexInst {
+    RegexOp op = RegexOp::Match;
+    std::uint16_t next = 0;
+    std::uint16_t alt = 0;
+    ByteSet set{};
+};
+
+template<std::size_t Capacity>
+struct RegexProgram {
+    std::array<RegexInst, Capacity> code{};
+    std::uint16_t start = 0;
+    std::uint16_t size = 0;
+};
+
+// Not constexpr: reaching it during constant evaluation is the compile error.
+void regex_syntax_error(const char* what);
+
+template<std::size_t PatternSize>
+class RegexCompiler {
+public:
+    static constexpr std::size_t kNodeCapacity = 3 * PatternSize + 4;
+    static constexpr std::size_t kCodeCapacity = 2 * kNodeCapacity + 2;
+
+    consteval explicit RegexCompiler(std::string_view pattern) : pattern_(pattern) {}
+
+    consteval RegexProgram<kCodeCapacity> compile() {
+        const std::uint16_t root = parse_alternation();
+        if (pos_ != pattern_.size()) {
+            regex_syntax_error("unbalanced ')'");
+        }
+        const std::uint16_t match = emit({RegexOp::Match});
+        program_.start = generate(root, match);
+        return program_;
+    }
+
+private:
+    enum class Kind : std::uint8_t { Set, Empty, Concat, Alternate, Star, Plus, Optional, LineStart, LineEnd };
+
+    struct Node {
+        Kind kind = Kind::Empty;
+        std::uint16_t left = 0;
+        std::uint16_t right = 0;
+        ByteSet set{};
+    };
+
+    consteval bool at_end() const { return pos_ == pattern_.size(); }
+    consteval char peek() const { return pattern_[pos_]; }
+
+    consteval std::uint16_t add(Node node) {
+        nodes_[node_count_] = node;
+        return static_cast<std::uint16_t>(node_count_++);
+    }
+
+    consteval std::uint16_t parse_alternation() {
+        std::uint16_t left = parse_sequence();
+        while (!at_end() && peek() == '|') {
+            ++pos_;
+            const std::uint16_t right = parse_sequence();
+            left = add({Kind::Alternate, left, right});
+        }
+        return left;
+    }
+
+    consteval std::uint16_t parse_sequence() {
+        std::uint16_t seq = add({Kind::Empty});
+        while (!at_end() && peek() != '|' && peek() != ')') {
+            const std::uint16_t item = parse_quantified();
+            seq = nodes_[seq].kind == Kind::Empty ? item : add({Kind::Concat, seq, item});
+        }
+        return seq;
+    }
+
+    consteval std::uint16_t parse_quantified() {
+        std::uint16_t atom = parse_atom();
+        while (!at_end() && (peek() == '*' || peek() == '+' || peek() == '?')) {
+            const char q = pattern_[pos_++];
+            if (q != '?' && nullable(atom)) {
+                regex_syntax_error("repetition of an expression that can match empty");
+            }
+            atom = add({q == '*' ? Kind::Star : q == '+' ? Kind::Plus : Kind::Optional, atom});
+        }
+        return atom;
+    }
+
+    consteval std::uint16_t parse_atom() {
+        const char c = pattern_[pos_++];
+        switch (c) {
+            case '(': {
+                const std::uint16_t inner = parse_alternation();
+                if (at_end() || peek() != ')') {
+                    regex_syntax_error("missing ')'");
+                }
+                ++pos_;
+                return inner;
+            }
+            case '*': case '+': case '?': case ')':
+                regex_syntax_error("unexpected metacharacter");
+                return 0;
+            case '^': return add({Kind::LineStart});
+            case '$': return add({Kind::LineEnd});
+            case '.': {
+                Node node{Kind::Set};
+                node.set.add('\n');
+                node.set.invert();
+                return add(node);
+            }
+            case '[': return add({Kind::Set, 0, 0, parse_class()});
+            case '\\': return add({Kind::Set, 0, 0, parse_escape()});
+            default: {
+                Node node{Kind::Set};
+                node.set.add(static_cast<unsigned char>(c));
+                return add(node);
+            }
+        }
+    }
+
+    consteval ByteSet parse_escape() {
+        if (at_end()) {
+            regex_syntax_error("trailing '\\\\'");
+        }
+        const char c = pattern_[pos_++];
+        ByteSet set;
+        switch (c) {
+            case 'd': case 'D': set.add_range('0', '9'); break;
+            case 'w': case 'W':
+                set.add_range('a', 'z');
+                set.add_range('A', 'Z');
+                set.add_range('0', '9');
+                set.add('_');
+                break;
+            case 's': case 'S':
+                for (char ws : {' ', '\t', '\n', '\r', '\f', '\v'}) {
+                    set.add(static_cast<unsigned char>(ws));
+                }
+                break;
+            case 'n': set.add('\n'); break;
+            case 't': set.add('\t'); break;
+            case 'r': set.add('\r'); break;
+            default: set.add(static_cast<unsigned char>(c)); break;
+        }
+        if (c == 'D' || c == 'W' || c == 'S') {
+            set.invert();
+        }
+        return set;
+    }
+
+    consteval ByteSet parse_class() {
+        ByteSet set;
+        const bool negate = !at_end() && peek() == '^';
+        pos_ += negate ? 1 : 0;
+        bool first = true;
+        while (!at_end() && (peek() != ']' || first)) {
+            first = false;
+            char c = pattern_[pos_++];
+            if (c == '\\') {
+                set.merge(parse_escape());
+                continue;
+            }
+            if (pos_ + 1 < pattern_.size() && peek() == '-' && pattern_[pos_ + 1] != ']') {
+                const char last = pattern_[pos_ + 1];
+                if (static_cast<unsigned char>(last) < static_cast<unsigned char>(c)) {
+                    regex_syntax_error("reversed range in class");
+                }
+                set.add_range(static_cast<unsigned char>(c), static_cast<unsigned char>(last));
+                pos_ += 2;
+            } else {
+                set.add(static_cast<unsigned char>(c));
+            }
+        }
+        if (at_end()) {
+            regex_syntax_error("missing ']'");
+        }
+        ++pos_;
+        if (negate) {
+            set.invert();
+        }
+        return set;
+    }
+
+    consteval bool nullable(std::uint16_t n) const {
+        const Node& node = nodes_[n];
+        switch (node.kind) {
+            case Kind::Set: return false;
+            case Kind::Concat: return nullable(node.left) && nullable(node.right);
+            case Kind::Alternate: return nullable(node.left) || nullable(node.right);
+            case Kind::Plus: return nullable(node.left);
+            default: return true; // Empty, Star, Optional and the anchors
+        }
+    }
+
+    consteval std::uint16_t emit(RegexInst inst) {
+        program_.code[program_.size] = inst;
+        return program_.size++;
+    }
+
+    // Generates code for node `n` followed by the code at `next`.
+    consteval std::uint16_t generate(std::uint16_t n, std::uint16_t next) {
+        const Node node = nodes_[n];
+        switch (node.kind) {
+            case Kind::Set: return emit({RegexOp::Class, next, 0, node.set});
+            case Kind::Empty: return next;
+            case Kind::Concat: return generate(node.left, generate(node.right, next));
+            case Kind::Alternate: {
+                const std::uint16_t a = generate(node.left, next);
+                const std::uint16_t b = generate(node.right, next);
+                return emit({RegexOp::Split, a, b});
+            }
+            case Kind::Star:
+            case Kind::Plus: {
+                const Node& child = nodes_[node.left];
+                if (child.kind == Kind::Set) {
+                    // Single-byte repetition loops without recursion.
+                    const std::uint16_t star = emit({RegexOp::StarClass, next, 0, child.set});
+                    return node.kind == Kind::Star ? star : emit({RegexOp::Class, star, 0, child.set});
+                }
+                const std::uint16_t loop = emit({RegexOp::Split});
+                const std::uint16_t body = generate(node.left, loop);
+                program_.code[loop].next = body;
+                program_.code[loop].alt = next;
+                return node.kind == Kind::Star ? loop : body;
+            }
+            case Kind::Optional: return emit({RegexOp::Split, generate(node.left, next), next});
+            case Kind::LineStart: return emit({RegexOp::LineStart, next});
+            case Kind::LineEnd: return emit({RegexOp::LineEnd, next});
+        }
+        return next;
+    }
+
+    std::string_view pattern_;
+    std::size_t pos_ = 0;
+    std::array<Node, kNodeCapacity> nodes_{};
+    std::size_t node_count_ = 0;
+    RegexProgram<kCodeCapacity> program_{};
+};
+
+template<const auto& Program, std::uint16_t Pc>
+bool regex_run(const char* begin, const char* s, const char* end) {
+    constexpr RegexInst inst = Program.code[Pc];
+    if constexpr (inst.op == RegexOp::Match) {
+        return true;
+    } else if constexpr (inst.op == RegexOp::Class) {
+        return s != end && inst.set.test(static_cast<unsigned char>(*s)) && regex_run<Program, inst.next>(begin, s + 1, end);
+    } else if constexpr (inst.op == RegexOp::StarClass) {
+        const char* p = s;
+        while (p != end && inst.set.test(static_cast<unsigned char>(*p))) {
+            ++p;
+        }
+        for (;; --p) {
+            if (regex_run<Program, inst.next>(begin, p, end)) {
+                return true;
+            }
+            if (p == s) {
+                return false;
+            }
+        }
+    } else if constexpr (inst.op == RegexOp::Split) {
+        return regex_run<Program, inst.next>(begin, s, end) || regex_run<Program, inst.alt>(begin, s, end);
+    } else if constexpr (inst.op == RegexOp::LineStart) {
+        return (s == begin || s[-1] == '\n') && regex_run<Program, inst.next>(begin, s, end);
+    } else {
+        return (s == end || *s == '\n') && regex_run<Program, inst.next>(begin, s, end);
+    }
+}
+
+template<FixedString Pattern>
+struct CompiledRegex {
+    static constexpr auto program = RegexCompiler<Pattern.view().size()>(Pattern.view()).compile();
+
+    // Offset of the leftmost match, or npos.
+    [[nodiscard]] static std::size_t search(std::string_view text) {
+        constexpr RegexInst first = program.code[program.start];
+        const char* begin = text.data();
+        const char* end = begin + text.size();
+        for (const char* s = begin;; ++s) {
+            if constexpr (first.op == RegexOp::Class) {
+                // Skip start positions that cannot match the first byte.
+                if constexpr (constexpr int byte = first.set.single(); byte >= 0) {
+                    s = static_cast<const char*>(std::memchr(s, byte, static_cast<std::size_t>(end - s)));
+                    if (s == nullptr) {
+                        return std::string_view::npos;
+                    }
+                } else {
+                    while (s != end && !first.set.test(static_cast<unsigned char>(*s))) {
+                        ++s;
+                    }
+                    if (s == end) {
+                        return std::string_view::npos;
+                    }
+                }
+            }
+            if (regex_run<program, program.start>(begin, s, end)) {
+                return static_cast<std::size_t>(s - begin);
+            }
+            if (s == end) {
+                return std::string_view::npos;
+            }
+        }
+    }
+};
+
+template<FixedString Pattern, FixedString FieldName, FixedString InvalidValue>
+struct RegexRule {
+    using Regex = CompiledRegex<Pattern>;
+    static constexpr std::string_view field_name = FieldName.view();
+    static constexpr std::string_view invalid_value = InvalidValue.view();
+};
+
+// A compile-time rule set for ValidateData. The reported error is the match
+// with the lowest offset; ties go to the rule listed first.
+template<class... Rules>
+struct RegexRuleSet {
+    [[nodiscard]] static std::optional<ValidationError> check(std::string_view text) {
+        std::size_t best_offset = std::string_view::npos;
+        std::size_t best_rule = 0;
+        std::size_t index = 0;
+        ((check_rule<Rules>(text, index++, best_offset, best_rule)), ...);
+        if (best_offset == std::string_view::npos) {
+            return std::nullopt;
+        }
+        static constexpr std::array<std::string_view, sizeof...(Rules)> fields = {Rules::field_name...};
+        static constexpr std::array<std::string_view, sizeof...(Rules)> values = {Rules::invalid_value...};
+        return ValidationError{fields[best_rule], values[best_rule], best_offset};
+    }
+
+private:
+    template<class Rule>
+    static void check_rule(std::string_view text, std::size_t index, std::size_t& best_offset, std::size_t& best_rule) {
+        const std::size_t offset = Rule::Regex::search(text);
+        if (offset < best_offset) {
+            best_offset = offset;
+            best_rule = index;
+        }
+    }
+};
+
+// FNV-1a; used for checksums, error grouping and the schema key hash.
+constexpr std::uint64_t fnv1a64(std::string_view bytes, std::uint64_t hash = 0xcbf29ce484222325ull) {
+    for (unsigned char c : bytes) {
+        hash ^= c;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// Schema-driven typed config extraction.
+// A schema lists the expected "key = value" entries and the struct members
+// they go into. The key set is turned into a perfect hash during compilation,
+// and ExtractConfig fills the struct in a single pass over the text. Unknown,
+// duplicate and missing keys and values of the wrong type are reported as a
+// ValidationError naming the real field and the offending value.
+// Lines are "key = value"; blank lines and lines starting with '#' are skipped.
+template<std::size_t N>
+struct PerfectHash {
+    static constexpr std::size_t kTableSize = std::bit_ceil(N * 2 + 1);
+
+    std::uint64_t seed = 0;
+    std::array<std::int16_t, kTableSize> slots{}; // field index, or -1
+
+    constexpr std::size_t slot(std::string_view key) const {
+        return static_cast<std::size_t>(fnv1a64(key, seed)) & (kTableSize - 1);
+    }
+};
+
+// Not constexpr: reaching it during constant evaluation is the compile error.
+void schema_definition_error(const char* what);
+
+// Searches seeds until every key lands in its own slot.
+template<std::size_t N>
+consteval PerfectHash<N> make_perfect_hash(const std::array<std::string_view, N>& keys) {
+    for (std::size_t i = 0; i < N; ++i) {
+        for (std::size_t j = i + 1; j < N; ++j) {
+            if (keys[i] == keys[j]) {
+                schema_definition_error("duplicate key in schema");
+            }
+        }
+    }
+    for (std::uint64_t seed = 0xcbf29ce484222325ull, attempt = 0; attempt < 100000; ++attempt, seed += 0x9e3779b97f4a7c15ull) {
+        PerfectHash<N> hash;
+        hash.seed = seed;
+        hash.slots.fill(-1);
+        bool collision = false;
+        for (std::size_t i = 0; i < N && !collision; ++i) {
+            auto& slot = hash.slots[hash.slot(keys[i])];
+            collision = slot >= 0;
+            slot = static_cast<std::int16_t>(i);
+        }
+        if (!collision) {
+            return hash;
+        }
+    }
+    schema_definition_error("no perfect hash seed found");
+    return {};
+}
+
+template<class T>
+struct MemberPointerTraits;
+
+template<class Struct, class Value>
+struct MemberPointerTraits<Value Struct::*> {
+    using StructType = Struct;
+    using ValueType = Value;
+};
+
+// Parses `text` into `out`; false on a type mismatch.
+inline bool parse_field_value(std::string_view text, std::string& out) {
+    out.assign(text);
+    return true;
+}
+
+inline bool parse_field_value(std::string_view text, bool& out) {
+    if (text == "true") {
+        out = true;
+        return true;
+    }
+    if (text == "false") {
+        out = false;
+        return true;
+    }
+    return false;
+}
+
+template<class Number>
+    requires std::is_arithmetic_v<Number>
+bool parse_field_value(std::string_view text, Number& out) {
+    const char* end = text.data() + text.size();
+    auto [ptr, ec] = std::from_chars(text.data(), end, out);
+    return ec == std::errc() && ptr == end;
+}
+
+template<FixedString Key, auto Member>
+struct SchemaField {
+    using Struct = typename MemberPointerTraits<decltype(Member)>::StructType;
+    static constexpr std::string_view key = Key.view();
+
+    static bool assign(Struct& target, std::string_view value) {
+        return parse_field_value(value, target.*Member);
+    }
+};
+
+template<class Struct, class... Fields>
+struct ConfigSchema {
+    static constexpr std::size_t kFieldCount = sizeof...(Fields);
+    static_assert(kFieldCount > 0 && kFieldCount < 64, "a schema has between 1 and 63 fields");
+    static constexpr std::array<std::string_view, kFieldCount> keys = {Fields::key...};
+    static constexpr PerfectHash<kFieldCount> hash = make_perfect_hash(keys);
+    static constexpr std::array<bool (*)(Struct&, std::string_view), kFieldCount> assign = {&Fields::assign...};
+
+    // Index of `key` in the schema, or -1.
+    static constexpr int find(std::string_view key) {
+        const int index = hash.slots[hash.slot(key)];
+        return index >= 0 && keys[static_cast<std::size_t>(index)] == key ? index : -1;
+    }
+};
+
+constexpr std::string_view trim_spaces(std::string_view s) {
+    const auto first = s.find_first_not_of(" \t\r");
+    if (first == std::string_view::npos) {
+        return {};
+    }
+    return s.substr(first, s.find_last_not_of(" \t\r") - first + 1);
+}
+
+template<class Struct, class... Fields>
+[[nodiscard]] std::expected<Struct, PipelineError> ExtractConfig(const Config& config, ConfigSchema<Struct, Fields...>) {
+    using Schema = ConfigSchema<Struct, Fields...>;
+    const std::string_view text = config.data;
+    Struct out{};
+    std::uint64_t seen = 0;
+    for (std::size_t line_start = 0; line_start < text.size();) {
+        std::size_t line_end = text.find('\n', line_start);
+        if (line_end == std::string_view::npos) {
+            line_end = text.size();
+        }
+        const std::string_view line = trim_spaces(text.substr(line_start, line_end - line_start));
+        const std::size_t offset = line_start;
+        line_start = line_end + 1;
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+
+        const std::size_t eq = line.find('=');
+        if (eq == std::string_view::npos) {
+            return std::unexpected(ValidationError{line, "expected 'key = value'", offset});
+        }
+        const std::string_view key = trim_spaces(line.substr(0, eq));
+        const std::string_view value = trim_spaces(line.substr(eq + 1));
+        const int index = Schema::find(key);
+        if (index < 0) {
+            return std::unexpected(ValidationError{key, "unknown key", offset});
+        }
+        const std::uint64_t bit = std::uint64_t{1} << index;
+        if ((seen & bit) != 0) {
+            return std::unexpected(ValidationError{key, "duplicate key", offset});
+        }
+        seen |= bit;
+        if (!Schema::assign[static_cast<std::size_t>(index)](out, value)) {
+            return std::unexpected(ValidationError{key, value, offset});
+        }
+    }
+    for (std::size_t i = 0; i < Schema::kFieldCount; ++i) {
+        if ((seen & (std::uint64_t{1} << i)) == 0) {
+            return std::unexpected(ValidationError{Schema::keys[i], "missing key"});
+        }
+    }
+    return out;
+}
+
+// Step 3: Implement Functions Returning std::expected with PipelineError
+// In-memory half of LoadConfig, also used by the fuzz harness.
+[[nodiscard]] std::expected<Config, PipelineError> ParseConfig(std::string content, std::string_view source,
+                                                               const RunLimit& limit = {}) {
+    const auto marker = find_token_limited(content, kMalformedMarker, limit);
+    if (!marker) {
+        return std::unexpected(limit.error("ParseConfig"));
+    }
+    // Simulate a parse error for empty config or specific content
+    if (content.empty() || *marker != std::string::npos) {
+        if (debug_logging_enabled()) {
+            std::cerr << "DEBUG: LoadConfig detected malformed config in " << source << std::endl;
+        }
+        return std::unexpected(ConfigParseError{"malformed", 1});
+    }
+    if (debug_logging_enabled()) {
+        std::cout << "DEBUG: Config loaded successfully from " << source << std::endl;
+    }
+    return Config{std::move(content)};
+}
+
+// Reads in kCancelCheckBytes blocks so an expired limit is seen between reads.
+[[nodiscard]] std::expected<Config, PipelineError> LoadConfig(const std::string& filename, const RunLimit& limit = {}) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        if (debug_logging_enabled()) {
+            std::cerr << "DEBUG: LoadConfig failed to open " << filename << std::endl;
+        }
+        return std::unexpected(ConfigReadError{filename});
+    }
+    std::string content;
+    if (const auto size = file.rdbuf()->pubseekoff(0, std::ios::end); size > 0) {
+        content.reserve(static_cast<std::size_t>(size) + 1); // +1: the read that hits EOF
+    }
+    file.rdbuf()->pubseekoff(0, std::ios::beg);
+    for (std::size_t done = 0; file;) {
+        if (limit.expired()) {
+            return std::unexpected(limit.error("LoadConfig"));
+        }
+        // Stay within the reserved capacity when the size is known.
+        const std::size_t block = content.capacity() > done ? std::min(kCancelCheckBytes, content.capacity() - done)
+                                                            : kCancelCheckBytes;
+        content.resize(done + block);
+        file.read(content.data() + done, static_cast<std::streamsize>(block));
+        done += static_cast<std::size_t>(file.gcount());
+        content.resize(done);
+    }
+    return ParseConfig(std::move(content), filename, limit);
+}
+
+// Build-time embedded config for sidecar binaries.
+// Compile with -DPIPELINE_EMBED_CONFIG='"sidecar.conf"' to bake the file into
+// the binary with #embed. Compilers without #embed take a byte list generated
+// at build time instead (-DPIPELINE_EMBED_CONFIG_BYTES='"sidecar.inc"', made
+// with `xxd -i < sidecar.conf > sidecar.inc`). The config is validated during
+// compilation, and LoadEmbeddedConfig offers the LoadConfig interface without
+// any file I/O.
+#if defined(PIPELINE_EMBED_CONFIG) || defined(PIPELINE_EMBED_CONFIG_BYTES)
+inline constexpr unsigned char kEmbeddedConfigBytes[] = {
+#if defined(PIPELINE_EMBED_CONFIG) && defined(__has_embed)
+#embed PIPELINE_EMBED_CONFIG
+#elif defined(PIPELINE_EMBED_CONFIG_BYTES)
+#include PIPELINE_EMBED_CONFIG_BYTES
+#else
+#error "this compiler lacks #embed; pass PIPELINE_EMBED_CONFIG_BYTES with a generated byte list"
+#endif
+};
+// An empty config is malformed for LoadConfig too; fail with a readable error
+// instead of a zero-size array or a constant-evaluation trace.
+static_assert(sizeof(kEmbeddedConfigBytes) > 0, "embedded config is empty");
+
+// The bytes as chars, so the text can be viewed during constant evaluation.
+inline constexpr auto kEmbeddedConfigChars = [] {
+    std::array<char, sizeof(kEmbeddedConfigBytes)> chars{};
+    for (std::size_t i = 0; i < chars.size(); ++i) {
+        chars[i] = static_cast<char>(kEmbeddedConfigBytes[i]);
+    }
+    return chars;
+}();
+
+inline constexpr Result kEmbeddedConfigResult =
+    validate_embedded_text<[] { return std::string_view(kEmbeddedConfigChars.data(), kEmbeddedConfigChars.size()); }>();
+
+// Zero-copy access to the embedded text.
+[[nodiscard]] constexpr std::string_view embedded_config_view() {
+    return {kEmbeddedConfigChars.data(), kEmbeddedConfigChars.size()};
+}
+
+// Same interface as LoadConfig; the text was already parsed at compile time.
+[[nodiscard]] std::expected<Config, PipelineError> LoadEmbeddedConfig() {
+    return Config{std::string(embedded_config_view())};
+}
+
+// The pipeline result for the embedded config, computed during compilation.
+[[nodiscard]] constexpr std::expected<Result, PipelineError> call_pipeline_embedded() {
+    return kEmbeddedConfigResult;
+}
+#endif
+
+// Success path shared by the ValidateData overloads.
+[[nodiscard]] ValidatedData accept_validated(const Config& config) {
+    if (debug_logging_enabled()) {
+        std::cout << "DEBUG: Data validated successfully." << std::endl;
+    }
+    std::string processed;
+    processed.reserve(kValidatedPrefix.size() + config.data.size());
+    processed += kValidatedPrefix;
+    processed += config.data;
+    return ValidatedData{std::move(processed)};
+}
+
+[[nodiscard]] std::expected<ValidatedData, PipelineError> ValidateData(const Config& config, const PatternRuleEngine& rules,
+                                                                      const RunLimit& limit = {}) {
+    // Reject the config on the first forbidden pattern
+    auto match = rules.find_first(config.data, default_scan_threads(), limit);
+    if (limit.expired()) {
+        return std::unexpected(limit.error("ValidateData"));
+    }
+    if (match) {
+        if (debug_logging_enabled()) {
+            std::cerr << "DEBUG: ValidateData detected invalid field." << std::endl;
+        }
+        return std::unexpected(rules.make_error(*match));
+    }
+    return accept_validated(config);
+}
+
+[[nodiscard]] std::expected<ValidatedData, PipelineError> ValidateData(const Config& config, const RunLimit& limit = {}) {
+    return ValidateData(config, default_rule_engine(), limit);
+}
+
+template<class... Rules>
+[[nodiscard]] std::expected<ValidatedData, PipelineError> ValidateData(const Config& config, RegexRuleSet<Rules...> rules) {
+    if (auto error = rules.check(config.data)) {
+        if (debug_logging_enabled()) {
+            std::cerr << "DEBUG: ValidateData detected invalid field." << std::endl;
+        }
+        return std::unexpected(std::move(*error));
+    }
+    return accept_validated(config);
+}
+
+// Accepts the config only if it matches the schema; use ExtractConfig to also
+// get the typed values.
+template<class Struct, class... Fields>
+[[nodiscard]] std::expected<ValidatedData, PipelineError> ValidateData(const Config& config, ConfigSchema<Struct, Fields...> schema) {
+    if (auto extracted = ExtractConfig(config, schema); !extracted) {
+        if (debug_logging_enabled()) {
+            std::cerr << "DEBUG: ValidateData detected invalid field." << std::endl;
+        }
+        return std::unexpected(std::move(extracted).error());
+    }
+    return accept_validated(config);
+}
+
+[[nodiscard]] std::expected<Result, PipelineError> ProcessData(const ValidatedData& data) {
+    // Simulate a processing error
+    if (data.processed_data.length() < kMinProcessedLength) {
+        if (debug_logging_enabled()) {
+            std::cerr << "DEBUG: ProcessData detected data too short." << std::endl;
+        }
+        return std::unexpected(ProcessingError{"Data Processing", "Input data too short for task"});
+    }
+    if (debug_logging_enabled()) {
+        std::cout << "DEBUG: Data processed successfully." << std::endl;
+    }
+    return Result{static_cast<int>(data.processed_data.length())};
+}
+
+// Step 5: Handling the Final Result with std::visit
+// Appends e.g. "1.250 ms".
+void append_milliseconds(std::string& out, std::chrono::nanoseconds duration) {
+    char digits[32];
+    const double ms = std::chrono::duration<double, std::milli>(duration).count();
+    const auto [end, ec] = std::to_chars(std::begin(digits), std::end(digits), ms, std::chars_format::fixed, 3);
+    out.append(digits, end);
+    out += " ms";
+}
+
+// Appends the human-readable description of `error` (without a newline), so
+// streams and the buffered renderer share one wording.
+void append_error_text(std::string& out, const PipelineError& error) {
+    // Truncated fields end in "..." so the cut is visible.
+    const auto text = [&out](const auto& field) {
+        out += field.view();
+        if (field.truncated()) {
+            out += "...";
+        }
+    };
+    std::visit(Overloaded {
+        [&](const ConfigReadError& e) {
+            out += "Configuration Read Error: Could not open file '";
+            text(e.filename);
+            out += "'";
+        },
+        [&](const ConfigParseError& e) {
+            out += "Configuration Parse Error: Malformed content at line ";
+            out += std::to_string(e.line_number);
+            out += " (Context: '";
+            text(e.line_content);
+            out += "')";
+        },
+        [&](const ValidationError& e) {
+            out += "Data Validation Error: Field '";
+            text(e.field_name);
+            out += "' has invalid value '";
+            text(e.invalid_value);
+            out += "'";
+            if (e.offset != std::string::npos) {
+                out += " at offset ";
+                out += std::to_string(e.offset);
+            }
+        },
+        [&](const ProcessingError& e) {
+            out += "Data Processing Error: Task '";
+            text(e.task_name);
+            out += "' failed. Details: ";
+            text(e.details);
+        },
+        [&out](const OutOfMemoryError& e) {
+            out += "Out of Memory Error: Stage '";
+            out += e.stage;
+            out += "' could not allocate ";
+            out += std::to_string(e.requested_bytes);
+            out += " bytes";
+        },
+        [&out](const Cancelled& e) {
+            out += "Cancelled: Stage '";
+            out += e.stage;
+            out += "' stopped on request";
+        },
+        [&out](const DeadlineExceeded& e) {
+            out += "Deadline Exceeded: Stage '";
+            out += e.stage;
+            out += "' ran ";
+            append_milliseconds(out, e.overrun);
+            out += e.run_budget ? " past the run's " : " past its ";
+            append_milliseconds(out, e.budget);
+            out += " budget";
+        },
+        // This generic lambda serves as a fallback for any unhandled types.
+        // For strict compile-time enforcement of exhaustiveness, a static_assert(false,...)
+        // could be used here if all types are expected to be handled.
+        [&out](auto&& arg) {
+            // This branch should ideally not be reachable if all specific error types are handled.
+            // In a production system, this might log an unexpected error type.
+            out += "An unexpected error type was encountered.";
+        }
+    }, error);
+}
+
+// One line per frame, innermost first.
+void print_error_context(const ErrorContext& context, std::ostream& os) {
+    const auto dropped = t_error_context.for_each(context, [&os](const ErrorContextFrame& frame, std::string_view file) {
+        os << "  in " << frame.stage;
+        if (!file.empty()) {
+            os << " ('" << file << "')";
+        }
+        os << " at " << frame.where.file_name() << ':' << frame.where.line() << " [" << frame.where.function_name() << "]\n";
+    });
+    if (dropped.value_or(0) > 0) {
+        os << "  (" << *dropped << " context frame(s) dropped)\n";
+    }
+}
+
+void print_pipeline_error(const PipelineError& error, std::ostream& os) {
+    std::string text;
+    append_error_text(text, error);
+    os << text << std::endl;
+    std::visit([&os](const auto& e) {
+        print_error_context(e.context, os);
+        print_captured_stack(e.stack, os);
+    }, error);
+}
+
+void handle_pipeline_result(const std::expected<Result, PipelineError>& final_result) {
+    if (final_result) {
+        std::cout << "\nPipeline Succeeded! Final Result Code: " << final_result->final_result_code << std::endl;
+    } else {
+        std::cerr << "\nPipeline Failed! Error details: ";
+        print_pipeline_error(final_result.error(), std::cerr);
+    }
+}
+
+// Rate-limited error reporting.
+// During an error storm, printing every failure makes the output sink the
+// bottleneck. ErrorReporter prints only the first few errors of each time
+// window in full and folds the rest into one summary line per error kind,
+// e.g. "ValidationError invalid_field x 12,345".
+std::string_view error_kind_name(const PipelineError& error) {
+    return error_traits(error).name;
+}
+
+// Errors with the same kind and key are aggregated together. The key is the
+// field that identifies the cause, so per-file details such as the filename
+// are left out.
+std::string error_aggregation_key(const PipelineError& error) {
+    std::string key(error_kind_name(error));
+    std::visit(Overloaded {
+        [](const ConfigReadError&) {},
+        [&key](const ConfigParseError& e) { key += ' '; key += e.line_content; },
+        [&key](const ValidationError& e) { key += ' '; key += e.field_name; },
+        [&key](const ProcessingError& e) { key += ' '; key += e.task_name; },
+        [&key](const OutOfMemoryError& e) { key += ' '; key += e.stage; },
+        [&key](const Cancelled& e) { key += ' '; key += e.stage; },
+        [&key](const DeadlineExceeded& e) { key += ' '; key += e.stage; },
+    }, error);
+    return key;
+}
+
+// Formats 12345 as "12,345".
+std::string format_count(std::uint64_t count) {
+    std::string digits = std::to_string(count);
+    std::string out;
+    for (std::size_t i = 0; i < digits.size(); ++i) {
+        if (i != 0 && (digits.size() - i) % 3 == 0) {
+            out += ',';
+        }
+        out += digits[i];
+    }
+    return out;
+}
+
+struct ErrorReporterOptions {
+    std::chrono::steady_clock::duration window = std::chrono::seconds(1);
+    std::size_t max_exemplars = 5; // errors printed in full per window
+};
+
+class ErrorReporter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit ErrorReporter(std::ostream& os, ErrorReporterOptions options = {})
+        : os_(os), options_(options) {}
+
+    ErrorReporter(const ErrorReporter&) = delete;
+    ErrorReporter& operator=(const ErrorReporter&) = delete;
+
+    ~ErrorReporter() { flush(); }
+
+    void report(const PipelineError& error, Clock::time_point now = Clock::now()) {
+        tick(now);
+        if (!window_open_) {
+            window_open_ = true;
+            window_start_ = now;
+        }
+        if (exemplars_ < options_.max_exemplars) {
+            ++exemplars_;
+            os_ << "Pipeline Failed! Error details: ";
+            print_pipeline_error(error, os_);
+        }
+        ++counts_[error_aggregation_key(error)];
+    }
+
+    // Flushes the current window once it has expired, so a storm's summary
+    // shows up even when no further error arrives. Call it periodically.
+    void tick(Clock::time_point now = Clock::now()) {
+        if (window_open_ && now - window_start_ >= options_.window) {
+            flush();
+        }
+    }
+
+    // Emits the summary of the current window and starts a new one.
+    void flush() {
+        if (!window_open_) {
+            return;
+        }
+        os_ << "Error summary:\n";
+        for (const auto& [key, count] : counts_) {
+            os_ << "  " << key << " x " << format_count(count) << '\n';
+        }
+        os_.flush();
+        counts_.clear();
+        exemplars_ = 0;
+        window_open_ = false;
+    }
+
+private:
+    std::ostream& os_;
+    ErrorReporterOptions options_;
+    bool window_open_ = false;
+    Clock::time_point window_start_;
+    std::size_t exemplars_ = 0;
+    std::map<std::string, std::uint64_t> counts_; // ordered for stable output
+};
+
+void handle_pipeline_result(const std::expected<Result, PipelineError>& final_result, ErrorReporter& reporter) {
+    if (final_result) {
+        reporter.tick();
+        std::cout << "\nPipeline Succeeded! Final Result Code: " << final_result->final_result_code << std::endl;
+    } else {
+        reporter.report(final_result.error());
+    }
+}
+
+// A helper function for unit tests calling pipeline.
+// Runs one stage under `limit`. A stage that returns after its deadline fails
+// too, so stages without long scans (ProcessData) are bounded at their end.
+template<class Stage>
+[[nodiscard]] auto run_limited(std::string_view stage_name, const RunLimit& limit, Stage&& stage)
+    -> std::invoke_result_t<Stage, const RunLimit&> {
+    auto result = std::forward<Stage>(stage)(limit);
+    if (result && limit.expired()) [[unlikely]] {
+        return std::unexpected(limit.error(stage_name));
+    }
+    return result;
+}
+
+// A failure carries context frames for the failing stage and for the caller.
+// Once `stop` is requested the run ends with a Cancelled error, and a stage
+// or run that goes over its budget ends with DeadlineExceeded.
+[[nodiscard]] std::expected<Result, PipelineError> call_pipeline(const std::string &configfile, const PipelineBudget& budget,
+                                                                 const std::stop_token& stop = {},
+                                                                 std::source_location caller = std::source_location::current()) {
+    t_error_context.begin_run();
+    const auto run_start = budget.total != PipelineBudget::kUnlimited ? RunLimit::Clock::now() : RunLimit::Clock::time_point{};
+    const auto stage_limit = [&](std::chrono::nanoseconds stage_budget) { return RunLimit(stop, run_start, budget, stage_budget); };
+    auto result = guard_allocations("call_pipeline", [&] {
+        return with_context(run_limited("LoadConfig", stage_limit(budget.load),
+                                        [&](const RunLimit& limit) { return LoadConfig(configfile, limit); }),
+                            "LoadConfig", configfile)
+           .and_then([&](const Config& cfg) {
+               return with_context(run_limited("ValidateData", stage_limit(budget.validate),
+                                               [&](const RunLimit& limit) { return ValidateData(cfg, limit); }),
+                                   "ValidateData", configfile);
+           })
+           .and_then([&](const ValidatedData& vd) {
+               return with_context(run_limited("ProcessData", stage_limit(budget.process),
+                                               [&](const RunLimit&) { return ProcessData(vd); }),
+                                   "ProcessData", configfile);
+           });
+    });
+    return with_context(std::move(result), "call_pipeline", configfile, caller);
+}
+
+[[nodiscard]] std::expected<Result, PipelineError> call_pipeline(const std::string &configfile, const std::stop_token& stop,
+                                                                 std::source_location caller = std::source_location::current()) {
+    return call_pipeline(configfile, PipelineBudget{}, stop, caller);
+}
+
+[[nodiscard]] std::expected<Result, PipelineError> call_pipeline(const std::string &configfile,
+                                                                 std::source_location caller = std::source_location::current()) {
+    return call_pipeline(configfile, PipelineBudget{}, std::stop_token{}, caller);
+}
+
+// Pipelined execution for batch runs.
+// LoadConfig is I/O-bound while ValidateData and ProcessData are CPU-bound, so
+// each stage gets its own thread and the stages are connected by bounded
+// single-producer/single-consumer queues. A full queue blocks the producer,
+// which applies backpressure to the faster stages. A failed item never enters
+// the downstream stages: it goes straight to the result sink. A blocked side
+// spins briefly, then sleeps in std::atomic::wait until the other side moves.
+inline constexpr int kQueueSpinsBeforeWait = 64;
+
+template<class T>
+class SpscQueue {
+public:
+    explicit SpscQueue(std::size_t capacity)
+        : mask_(std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1), slots_(mask_ + 1) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    bool try_push(T& value) {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ > mask_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ > mask_) {
+                return false;
+            }
+        }
+        slots_[tail & mask_] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        tail_.notify_one();
+        return true;
+    }
+
+    bool try_pop(T& value) {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) {
+                return false;
+            }
+        }
+        value = std::move(slots_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        head_.notify_one();
+        return true;
+    }
+
+    void push(T value) {
+        for (int spins = 0; !try_push(value); ++spins) {
+            if (spins >= kQueueSpinsBeforeWait) {
+                const std::size_t head = head_.load(std::memory_order_acquire);
+                if (tail_.load(std::memory_order_relaxed) - head > mask_) {
+                    head_.wait(head, std::memory_order_acquire); // still full
+                }
+            }
+        }
+    }
+
+    T pop() {
+        T value;
+        for (int spins = 0; !try_pop(value); ++spins) {
+            if (spins >= kQueueSpinsBeforeWait) {
+                const std::size_t tail = tail_.load(std::memory_order_acquire);
+                if (tail == head_.load(std::memory_order_relaxed)) {
+                    tail_.wait(tail, std::memory_order_acquire); // still empty
+                }
+            }
+        }
+        return value;
+    }
+
+private:
+    const std::size_t mask_;
+    std::vector<T> slots_;
+    // Producer and consumer indices live on separate cache lines; each side
+    // keeps a cached copy of the other's index to avoid needless sharing.
+    alignas(64) std::atomic<std::size_t> head_{0};
+    std::size_t cached_tail_ = 0;
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    std::size_t cached_head_ = 0;
+};
+
+template<class T>
+struct PipelineItem {
+    std::size_t index = 0;
+    std::expected<T, PipelineError> value;
+};
+
+[[nodiscard]] std::vector<std::expected<Result, PipelineError>>
+call_pipeline_pipelined(const std::vector<std::string>& configfiles, std::size_t queue_capacity = 64) {
+    const std::size_t count = configfiles.size();
+    SpscQueue<PipelineItem<Config>> loaded(queue_capacity);
+    SpscQueue<PipelineItem<ValidatedData>> validated(queue_capacity);
+    // One error queue per upstream stage keeps every queue single-producer.
+    SpscQueue<PipelineItem<Result>> load_errors(queue_capacity);
+    SpscQueue<PipelineItem<Result>> validate_errors(queue_capacity);
+    SpscQueue<PipelineItem<Result>> processed(queue_capacity);
+
+    // The sink reads three queues, so producers also bump `sink_ready` for it
+    // to wait on.
+    std::atomic<std::uint32_t> sink_ready{0};
+    const auto to_sink = [&sink_ready](SpscQueue<PipelineItem<Result>>& queue, PipelineItem<Result> item) {
+        queue.push(std::move(item));
+        sink_ready.fetch_add(1, std::memory_order_release);
+        sink_ready.notify_one();
+    };
+    // Each stage runs like it does in call_pipeline: allocation failures become
+    // OutOfMemoryError and failures get a context frame. Chains recorded on
+    // the stage threads cannot be printed from the calling thread.
+    const auto run_stage = [](std::string_view stage, const std::string& file, auto&& body) {
+        t_error_context.begin_run();
+        return with_context(guard_allocations(stage, body), stage, file);
+    };
+
+    // Every item is forwarded to exactly one queue, so the sink is done after
+    // `count` results. Stage-to-stage queues end with an index == count marker.
+    std::jthread loader([&] {
+        for (std::size_t i = 0; i < count; ++i) {
+            auto cfg = run_stage("LoadConfig", configfiles[i], [&] { return LoadConfig(configfiles[i]); });
+            if (cfg) {
+                loaded.push({i, std::move(cfg)});
+            } else {
+                to_sink(load_errors, {i, std::unexpected(std::move(cfg).error())});
+            }
+        }
+        loaded.push({count, Config{}}); // end of stream
+    });
+    std::jthread validator([&] {
+        for (auto item = loaded.pop(); item.index != count; item = loaded.pop()) {
+            auto vd = run_stage("ValidateData", configfiles[item.index], [&] { return ValidateData(*item.value); });
+            if (vd) {
+                validated.push({item.index, std::move(vd)});
+            } else {
+                to_sink(validate_errors, {item.index, std::unexpected(std::move(vd).error())});
+            }
+        }
+        validated.push({count, ValidatedData{}});
+    });
+    std::jthread processor([&] {
+        for (auto item = validated.pop(); item.index != count; item = validated.pop()) {
+            to_sink(processed, {item.index, run_stage("ProcessData", configfiles[item.index],
+                                                      [&] { return ProcessData(*item.value); })});
+        }
+    });
+
+    // The calling thread is the result sink.
+    std::vector<std::expected<Result, PipelineError>> results(count);
+    std::array<SpscQueue<PipelineItem<Result>>*, 3> sources = {&load_errors, &validate_errors, &processed};
+    for (std::size_t received = 0, spins = 0; received < count;) {
+        const std::uint32_t ready = sink_ready.load(std::memory_order_acquire);
+        bool progress = false;
+        for (auto* source : sources) {
+            PipelineItem<Result> item;
+            while (source->try_pop(item)) {
+                results[item.index] = std::move(item.value);
+                ++received;
+                progress = true;
+            }
+        }
+        spins = progress ? 0 : spins + 1;
+        if (spins > kQueueSpinsBeforeWait) {
+            sink_ready.wait(ready, std::memory_order_acquire);
+        }
+    }
+    return results;
+}
+
+// Compiled binary config image for fast startup.
+// CompileConfigImage runs the text path (LoadConfig + ValidateData) once and
+// writes the validated payloads into a versioned, checksummed image. At
+// startup ConfigImage maps that file and hands out ValidatedData directly,
+// skipping parsing and validation. Image problems are reported as
+// ConfigReadError / ConfigParseError and call_pipeline falls back to the text
+// path.
+//
+// Layout (little-endian, all fields read with memcpy so no alignment is needed):
+//   ImageHeader | ImageEntry[entry_count] | string blob (names and payloads)
+// Entries are sorted by name so Lookup is a binary search. Each entry records
+// the source file size and mtime so a stale entry is detected without reading
+// the source.
+
+// True when [offset, offset + size) lies inside `blob`. Written as
+// `size <= blob - offset` so huge offsets from a damaged file cannot wrap.
+constexpr bool in_blob(std::string_view blob, std::uint64_t offset, std::uint64_t size) {
+    return offset <= blob.size() && size <= blob.size() - offset;
+}
+
+struct ImageHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t entry_count;
+    std::uint64_t checksum; // FNV-1a over everything after the header
+    std::uint64_t total_size;
+};
+
+struct ImageEntry {
+    std::uint64_t name_offset;
+    std::uint64_t name_size;
+    std::uint64_t data_offset;
+    std::uint64_t data_size;
+    std::uint64_t source_size;
+    std::int64_t source_mtime;
+};
+
+inline constexpr char kImageMagic[8] = {'P', 'I', 'P', 'E', 'C', 'F', 'G', '\0'};
+inline constexpr std::uint32_t kImageVersion = 2;
+
+struct SourceStamp {
+    std::uint64_t size = 0;
+    std::int64_t mtime = 0;
+};
+
+std::optional<SourceStamp> stat_source(const std::string& filename) {
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(filename, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    const auto mtime = std::filesystem::last_write_time(filename, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    return SourceStamp{size, static_cast<std::int64_t>(mtime.time_since_epoch().count())};
+}
+
+[[nodiscard]] std::expected<void, PipelineError> CompileConfigImage(const std::vector<std::string>& configfiles,
+                                                                    const std::string& image_path) {
+    std::vector<ImageEntry> entries;
+    std::string blob;
+    for (const auto& filename : configfiles) {
+        auto stamp = stat_source(filename);
+        auto validated = LoadConfig(filename).and_then([](const Config& cfg) { return ValidateData(cfg); });
+        if (!validated) {
+            return std::unexpected(std::move(validated).error());
+        }
+        if (!stamp) {
+            return std::unexpected(ConfigReadError{filename});
+        }
+        ImageEntry entry{};
+        entry.name_offset = blob.size();
+        entry.name_size = filename.size();
+        blob += filename;
+        entry.data_offset = blob.size();
+        entry.data_size = validated->processed_data.size();
+        blob += validated->processed_data;
+        entry.source_size = stamp->size;
+        entry.source_mtime = stamp->mtime;
+        entries.push_back(entry);
+    }
+    const auto name_of = [&blob](const ImageEntry& e) { return std::string_view(blob).substr(e.name_offset, e.name_size); };
+    std::ranges::stable_sort(entries, {}, name_of);
+
+    std::string body(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(ImageEntry));
+    body += blob;
+    ImageHeader header{};
+    std::memcpy(header.magic, kImageMagic, sizeof(header.magic));
+    header.version = kImageVersion;
+    header.entry_count = static_cast<std::uint32_t>(entries.size());
+    header.checksum = fnv1a64(body);
+    header.total_size = sizeof(ImageHeader) + body.size();
+
+    // Write to a temporary file and rename it so readers never map a half-written image.
+    const std::string tmp_path = image_path + ".tmp";
+    {
+        std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(body.data(), static_cast<std::streamsize>(body.size()));
+        if (!out) {
+            std::remove(tmp_path.c_str());
+            return std::unexpected(ConfigReadError{image_path});
+        }
+    }
+    if (std::rename(tmp_path.c_str(), image_path.c_str()) != 0) {
+        std::remove(tmp_path.c_str());
+        return std::unexpected(ConfigReadError{image_path});
+    }
+    return {};
+}
+
+class ConfigImage {
+public:
+    [[nodiscard]] static std::expected<ConfigImage, PipelineError> Open(const std::string& image_path) {
+        const int fd = ::open(image_path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return std::unexpected(ConfigReadError{image_path});
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(ImageHeader))) {
+            ::close(fd);
+            return std::unexpected(ConfigParseError{"truncated config image", 0});
+        }
+        const auto size = static_cast<std::size_t>(st.st_size);
+        void* addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED) {
+            return std::unexpected(ConfigReadError{image_path});
+        }
+        ConfigImage image(static_cast<const char*>(addr), size);
+
+        ImageHeader header;
+        std::memcpy(&header, image.base_, sizeof(header));
+        if (std::memcmp(header.magic, kImageMagic, sizeof(kImageMagic)) != 0 || header.version != kImageVersion) {
+            return std::unexpected(ConfigParseError{"unsupported config image version", 0});
+        }
+        const std::string_view body(image.base_ + sizeof(ImageHeader), size - sizeof(ImageHeader));
+        if (header.total_size != size || header.entry_count > body.size() / sizeof(ImageEntry) ||
+            fnv1a64(body) != header.checksum) {
+            return std::unexpected(ConfigParseError{"config image checksum mismatch", 0});
+        }
+        image.entry_count_ = header.entry_count;
+        image.blob_ = body.substr(header.entry_count * sizeof(ImageEntry));
+        std::string_view previous;
+        for (std::size_t i = 0; i < image.entry_count_; ++i) {
+            const ImageEntry e = image.entry(i);
+            if (!in_blob(image.blob_, e.name_offset, e.name_size) || !in_blob(image.blob_, e.data_offset, e.data_size)) {
+                return std::unexpected(ConfigParseError{"config image entry out of bounds", static_cast<int>(i)});
+            }
+            const std::string_view name = image.blob_.substr(e.name_offset, e.name_size);
+            if (i > 0 && name < previous) {
+                return std::unexpected(ConfigParseError{"config image entries not sorted", static_cast<int>(i)});
+            }
+            previous = name;
+        }
+        return image;
+    }
+
+    ConfigImage(ConfigImage&& other) noexcept
+        : base_(std::exchange(other.base_, nullptr)), size_(std::exchange(other.size_, 0)),
+          entry_count_(other.entry_count_), blob_(other.blob_) {}
+
+    ConfigImage& operator=(ConfigImage&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            base_ = std::exchange(other.base_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            entry_count_ = other.entry_count_;
+            blob_ = other.blob_;
+        }
+        return *this;
+    }
+
+    ~ConfigImage() { unmap(); }
+
+    // Returns the validated payload for `filename` without touching its text.
+    // A missing or out-of-date entry is a ConfigReadError.
+    [[nodiscard]] std::expected<ValidatedData, PipelineError> Lookup(const std::string& filename) const {
+        std::size_t lo = 0;
+        std::size_t hi = entry_count_;
+        while (lo < hi) {
+            const std::size_t mid = lo + (hi - lo) / 2;
+            if (name(entry(mid)) < filename) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        if (lo == entry_count_ || name(entry(lo)) != filename) {
+            return std::unexpected(ConfigReadError{filename});
+        }
+        const ImageEntry e = entry(lo);
+        auto stamp = stat_source(filename);
+        if (!stamp || stamp->size != e.source_size || stamp->mtime != e.source_mtime) {
+            return std::unexpected(ConfigReadError{filename});
+        }
+        return ValidatedData{std::string(blob_.substr(e.data_offset, e.data_size))};
+    }
+
+    std::size_t size() const { return entry_count_; }
+
+private:
+    ConfigImage(const char* base, std::size_t size) : base_(base), size_(size) {}
+
+    ImageEntry entry(std::size_t i) const {
+        ImageEntry e;
+        std::memcpy(&e, base_ + sizeof(ImageHeader) + i * sizeof(ImageEntry), sizeof(e));
+        return e;
+    }
+
+    std::string_view name(const ImageEntry& e) const { return blob_.substr(e.name_offset, e.name_size); }
+
+    void unmap() {
+        if (base_ != nullptr) {
+            ::munmap(const_cast<char*>(base_), size_);
+        }
+    }
+
+    const char* base_ = nullptr;
+    std::size_t size_ = 0;
+    std::size_t entry_count_ = 0;
+    std::string_view blob_;
+};
+
+// Uses the compiled image when it has an up-to-date entry, and otherwise falls
+// back to the text path.
+[[nodiscard]] std::expected<Result, PipelineError> call_pipeline(const std::string& configfile,
+                                                                 const ConfigImage& image) {
+    auto validated = image.Lookup(configfile);
+    if (!validated) {
+        if (debug_logging_enabled()) {
+            std::cerr << "DEBUG: config image miss for " << configfile << ", using text path" << std::endl;
+        }
+        return call_pipeline(configfile);
+    }
+    t_error_context.begin_run();
+    return with_context(ProcessData(*validated), "ProcessData", configfile);
+}
+
+// Batch error deduplication.
+// A large batch usually fails for a handful of distinct causes. Instead of
+// keeping one PipelineError per failed file, errors with the same alternative
+// and the same fields (ignoring the filename) are stored once per group, with
+// a count and the indices of the affected files.
+[[nodiscard]] std::uint64_t error_cause_hash(const PipelineError& error) {
+    const auto mix = [](std::uint64_t h, std::string_view field) {
+        h = fnv1a64(field, h);
+        return fnv1a64(std::string_view("\0", 1), h); // field separator
+    };
+    std::uint64_t h = fnv1a64(error_kind_name(error));
+    std::visit(Overloaded {
+        [](const ConfigReadError&) {},
+        [&](const ConfigParseError& e) { h = mix(mix(h, e.line_content), std::to_string(e.line_number)); },
+        [&](const ValidationError& e) { h = mix(mix(h, e.field_name), e.invalid_value); },
+        [&](const ProcessingError& e) { h = mix(mix(h, e.task_name), e.details); },
+        [&](const OutOfMemoryError& e) { h = mix(mix(h, e.stage), std::to_string(e.requested_bytes)); },
+        [&](const Cancelled& e) { h = mix(h, e.stage); },
+        [&](const DeadlineExceeded& e) { h = mix(mix(h, e.stage), std::to_string(e.budget.count())); },
+    }, error);
+    return h;
+}
+
+[[nodiscard]] bool same_error_cause(const PipelineError& a, const PipelineError& b) {
+    if (a.index() != b.index()) {
+        return false;
+    }
+    return std::visit(Overloaded {
+        [](const ConfigReadError&) { return true; },
+        [&b](const ConfigParseError& e) {
+            const auto& o = std::get<ConfigParseError>(b);
+            return e.line_content == o.line_content && e.line_number == o.line_number;
+        },
+        [&b](const ValidationError& e) {
+            const auto& o = std::get<ValidationError>(b);
+            return e.field_name == o.field_name && e.invalid_value == o.invalid_value;
+        },
+        [&b](const ProcessingError& e) {
+            const auto& o = std::get<ProcessingError>(b);
+            return e.task_name == o.task_name && e.details == o.details;
+        },
+        [&b](const OutOfMemoryError& e) {
+            const auto& o = std::get<OutOfMemoryError>(b);
+            return e.stage == o.stage && e.requested_bytes == o.requested_bytes;
+        },
+        [&b](const Cancelled& e) { return e.stage == std::get<Cancelled>(b).stage; },
+        [&b](const DeadlineExceeded& e) {
+            const auto& o = std::get<DeadlineExceeded>(b);
+            return e.stage == o.stage && e.budget == o.budget && e.run_budget == o.run_budget;
+        },
+    }, a);
+}
+
+struct ErrorGroup {
+    PipelineError error; // representative; its filename is the first affected file's
+    std::uint64_t count = 0;
+    std::vector<std::uint32_t> files; // indices into the batch's file list
+};
+
+struct BatchSummary {
+    std::uint64_t succeeded = 0;
+    std::vector<ErrorGroup> groups; // in order of first occurrence
+};
+
+class BatchErrorDeduplicator {
+public:
+    void add_success() { ++summary_.succeeded; }
+
+    void add_error(std::uint32_t file_index, PipelineError&& error) {
+        auto& candidates = index_[error_cause_hash(error)];
+        for (std::size_t group_index : candidates) {
+            ErrorGroup& group = summary_.groups[group_index];
+            if (same_error_cause(group.error, error)) {
+                ++group.count;
+                group.files.push_back(file_index);
+                return;
+            }
+        }
+        candidates.push_back(summary_.groups.size());
+        std::visit([](auto& e) { e.context = {}; }, error); // a group spans many runs
+        summary_.groups.push_back(ErrorGroup{std::move(error), 1, {file_index}});
+    }
+
+    [[nodiscard]] BatchSummary take() && { return std::move(summary_); }
+
+private:
+    BatchSummary summary_;
+    std::unordered_map<std::uint64_t, std::vector<std::size_t>> index_;
+};
+
+[[nodiscard]] BatchSummary call_pipeline_batch(const std::vector<std::string>& configfiles) {
+    BatchErrorDeduplicator dedup;
+    for (std::size_t i = 0; i < configfiles.size(); ++i) {
+        auto result = call_pipeline(configfiles[i]);
+        if (result) {
+            dedup.add_success();
+        } else {
+            dedup.add_error(static_cast<std::uint32_t>(i), std::move(result).error());
+        }
+    }
+    return std::move(dedup).take();
+}
+
+// Prints one block per distinct cause, listing at most `max_files` files each.
+void print_batch_summary(const BatchSummary& summary, const std::vector<std::string>& configfiles,
+                         std::ostream& os, std::size_t max_files = 5) {
+    os << "Batch: " << format_count(summary.succeeded) << " succeeded, "
+       << summary.groups.size() << " distinct error(s)" << std::endl;
+    for (const auto& group : summary.groups) {
+        os << format_count(group.count) << " x ";
+        print_pipeline_error(group.error, os);
+        os << "  files:";
+        const std::size_t shown = std::min(max_files, group.files.size());
+        for (std::size_t i = 0; i < shown; ++i) {
+            os << ' ' << configfiles[group.files[i]];
+        }
+        if (group.files.size() > shown) {
+            os << " (and " << format_count(group.files.size() - shown) << " more)";
+        }
+        os << std::endl;
+    }
+}
+
+// Buffered, batched result rendering.
+// handle_pipeline_result writes every fragment to std::cerr and flushes with
+// std::endl, which costs several write syscalls per result. ResultRenderer
+// formats results into a set of reusable chunk buffers and hands them to the
+// kernel in one writev call once enough output has accumulated.
+enum class RenderFormat {
+    Text,      // same wording as handle_pipeline_result, one line per result
+    JsonLines, // one JSON object per line
+    Binary,    // tag byte + little-endian fields, see append_binary()
+};
+
+class ResultRenderer {
+public:
+    static constexpr std::size_t kChunkSize = 64 * 1024;
+
+    explicit ResultRenderer(int fd, RenderFormat format = RenderFormat::Text,
+                            std::size_t flush_threshold = 1024 * 1024)
+        : fd_(fd), format_(format), flush_threshold_(flush_threshold) {}
+
+    ResultRenderer(const ResultRenderer&) = delete;
+    ResultRenderer& operator=(const ResultRenderer&) = delete;
+
+    ~ResultRenderer() { flush(); }
+
+    void render(const std::expected<Result, PipelineError>& result) {
+        std::string& out = current_chunk();
+        const std::size_t before = out.size();
+        switch (format_) {
+            case RenderFormat::Text: append_text(out, result); break;
+            case RenderFormat::JsonLines: append_json(out, result); break;
+            case RenderFormat::Binary: append_binary(out, result); break;
+        }
+        pending_ += out.size() - before;
+        if (pending_ >= flush_threshold_) {
+            flush();
+        }
+    }
+
+    // Writes all buffered output; returns false if the descriptor failed.
+    bool flush() {
+        std::vector<iovec> iov;
+        for (std::size_t i = 0; i <= used_ && i < chunks_.size(); ++i) {
+            if (!chunks_[i].empty()) {
+                iov.push_back({chunks_[i].data(), chunks_[i].size()});
+            }
+        }
+        bool ok = true;
+        for (std::size_t first = 0; first < iov.size();) {
+            const int count = static_cast<int>(std::min<std::size_t>(iov.size() - first, IOV_MAX));
+            const ssize_t written = ::writev(fd_, iov.data() + first, count);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                ok = false;
+                break;
+            }
+            // Skip fully written buffers and advance into a partially written one.
+            auto remaining = static_cast<std::size_t>(written);
+            while (first < iov.size() && remaining >= iov[first].iov_len) {
+                remaining -= iov[first].iov_len;
+                ++first;
+            }
+            if (remaining > 0) {
+                iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + remaining;
+                iov[first].iov_len -= remaining;
+            }
+        }
+        // Keep the chunk capacity for the next batch.
+        for (auto& chunk : chunks_) {
+            chunk.clear();
+        }
+        used_ = 0;
+        pending_ = 0;
+        return ok;
+    }
+
+    static void append_text(std::string& out, const std::expected<Result, PipelineError>& result) {
+        if (result) {
+            out += "Pipeline Succeeded! Final Result Code: ";
+            append_int(out, result->final_result_code);
+        } else {
+            out += "Pipeline Failed! Error details: ";
+            append_error_text(out, result.error());
+        }
+        out += '\n';
+    }
+
+    static void append_json(std::string& out, const std::expected<Result, PipelineError>& result) {
+        if (result) {
+            out += "{\"ok\":true,\"final_result_code\":";
+            append_int(out, result->final_result_code);
+            out += "}\n";
+            return;
+        }
+        out += "{\"ok\":false,\"error\":\"";
+        out += error_kind_name(result.error());
+        out += '"';
+        const auto field = [&out](std::string_view name, std::string_view value) {
+            out += ",\"";
+            out += name;
+            out += "\":\"";
+            append_json_escaped(out, value);
+            out += '"';
+        };
+        std::visit(Overloaded {
+            [&](const ConfigReadError& e) { field("filename", e.filename); },
+            [&](const ConfigParseError& e) {
+                field("line_content", e.line_content);
+                out += ",\"line_number\":";
+                append_int(out, e.line_number);
+            },
+            [&](const ValidationError& e) {
+                field("field_name", e.field_name);
+                field("invalid_value", e.invalid_value);
+                if (e.offset != std::string::npos) {
+                    out += ",\"offset\":";
+                    out += std::to_string(e.offset);
+                }
+            },
+            [&](const ProcessingError& e) { field("task_name", e.task_name); field("details", e.details); },
+            [&](const OutOfMemoryError& e) {
+                field("stage", e.stage);
+                out += ",\"requested_bytes\":";
+                out += std::to_string(e.requested_bytes);
+            },
+            [&](const Cancelled& e) { field("stage", e.stage); },
+            [&](const DeadlineExceeded& e) {
+                field("stage", e.stage);
+                out += ",\"budget_ns\":";
+                out += std::to_string(e.budget.count());
+                out += ",\"overrun_ns\":";
+                out += std::to_string(e.overrun.count());
+                out += e.run_budget ? ",\"run_budget\":true" : ",\"run_budget\":false";
+            },
+        }, result.error());
+        out += "}\n";
+    }
+
+    // Record layout: one tag byte (0 = Result, else the error's stable code),
+    // then either the i32 result code or the error fields in declaration
+    // order, strings as u32 length + bytes, integers as i32, sizes and
+    // offsets as u64 (an unknown offset is all ones), durations as u64
+    // nanoseconds and flags as one byte.
+    static void append_binary(std::string& out, const std::expected<Result, PipelineError>& result) {
+        const auto u32 = [&out](std::uint32_t v) {
+            for (int shift = 0; shift < 32; shift += 8) {
+                out += static_cast<char>((v >> shift) & 0xff);
+            }
+        };
+        const auto u64 = [&u32](std::uint64_t v) {
+            u32(static_cast<std::uint32_t>(v));
+            u32(static_cast<std::uint32_t>(v >> 32));
+        };
+        const auto str = [&](std::string_view v) {
+            u32(static_cast<std::uint32_t>(v.size()));
+            out += v;
+        };
+        if (result) {
+            out += static_cast<char>(0);
+            u32(static_cast<std::uint32_t>(result->final_result_code));
+            return;
+        }
+        out += static_cast<char>(error_traits(result.error()).code);
+        std::visit(Overloaded {
+            [&](const ConfigReadError& e) { str(e.filename); },
+            [&](const ConfigParseError& e) { str(e.line_content); u32(static_cast<std::uint32_t>(e.line_number)); },
+            [&](const ValidationError& e) { str(e.field_name); str(e.invalid_value); u64(e.offset); },
+            [&](const ProcessingError& e) { str(e.task_name); str(e.details); },
+            [&](const OutOfMemoryError& e) { str(e.stage); u64(e.requested_bytes); },
+            [&](const Cancelled& e) { str(e.stage); },
+            [&](const DeadlineExceeded& e) {
+                str(e.stage);
+                u64(static_cast<std::uint64_t>(e.budget.count()));
+                u64(static_cast<std::uint64_t>(e.overrun.count()));
+                out += static_cast<char>(e.run_budget);
+            },
+        }, result.error());
+    }
+
+private:
+    static void append_int(std::string& out, int value) {
+        char digits[16];
+        auto [end, ec] = std::to_chars(std::begin(digits), std::end(digits), value);
+        out.append(digits, end);
+    }
+
+    static void append_json_escaped(std::string& out, std::string_view value) {
+        static constexpr char hex[] = "0123456789abcdef";
+        for (unsigned char c : value) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += static_cast<char>(c);
+            } else if (c < 0x20) {
+                out += "\\u00";
+                out += hex[c >> 4];
+                out += hex[c & 0xf];
+            } else {
+                out += static_cast<char>(c);
+            }
+        }
+    }
+
+    // Returns the chunk to append to, moving on once the current one is full.
+    std::string& current_chunk() {
+        if (chunks_.empty()) {
+            chunks_.emplace_back().reserve(kChunkSize);
+        }
+        if (chunks_[used_].size() >= kChunkSize) {
+            if (++used_ == chunks_.size()) {
+                chunks_.emplace_back().reserve(kChunkSize);
+            }
+        }
+        return chunks_[used_];
+    }
+
+    int fd_;
+    RenderFormat format_;
+    std::size_t flush_threshold_;
+    std::vector<std::string> chunks_;
+    std::size_t used_ = 0;
+    std::size_t pending_ = 0;
+};
+
+// Stage names travel as strings in the binary format; decoding maps them back
+// to these literals so the decoded error does not point into the input.
+inline constexpr std::string_view kStageNames[] = {
+    "LoadConfig", "ParseConfig", "ValidateData", "ProcessData", "call_pipeline", "call_pipeline_in_memory",
+};
+
+std::string_view intern_stage_name(std::string_view name) {
+    for (std::string_view known : kStageNames) {
+        if (known == name) {
+            return known;
+        }
+    }
+    return "<unknown stage>";
+}
+
+// Decodes one record written by ResultRenderer::append_binary from the front
+// of `in` and advances past it; nullopt for a truncated or unknown record.
+// Decoded errors carry no stack or context.
+[[nodiscard]] std::optional<std::expected<Result, PipelineError>> decode_binary_result(std::string_view& in) {
+    std::string_view rest = in;
+    bool ok = true;
+    const auto bytes = [&](std::size_t n) {
+        if (!ok || rest.size() < n) {
+            ok = false;
+            return std::string_view{};
+        }
+        const std::string_view out = rest.substr(0, n);
+        rest.remove_prefix(n);
+        return out;
+    };
+    const auto u32 = [&] {
+        const std::string_view b = bytes(4);
+        std::uint32_t v = 0;
+        for (std::size_t i = 0; i < b.size(); ++i) {
+            v |= static_cast<std::uint32_t>(static_cast<unsigned char>(b[i])) << (8 * i);
+        }
+        return v;
+    };
+    const auto u64 = [&] {
+        const std::uint64_t low = u32();
+        return low | (std::uint64_t{u32()} << 32);
+    };
+    const auto str = [&] { return bytes(u32()); };
+    const auto ns = [&] { return std::chrono::nanoseconds(static_cast<std::int64_t>(u64())); };
+
+    const std::string_view tag = bytes(1);
+    if (!ok) {
+        return std::nullopt;
+    }
+    if (tag[0] == 0) {
+        const Result value{static_cast<int>(u32())};
+        if (!ok) {
+            return std::nullopt;
+        }
+        in = rest;
+        return std::expected<Result, PipelineError>(value);
+    }
+    const auto kind = error_kind_from_code(static_cast<unsigned char>(tag[0]));
+    if (!kind) {
+        return std::nullopt;
+    }
+    const auto decode_error = [&](PipelineErrorKind k) -> PipelineError {
+        switch (k) {
+            case PipelineErrorKind::ConfigRead: return ConfigReadError{str()};
+            case PipelineErrorKind::ConfigParse: {
+                const std::string_view line = str();
+                return ConfigParseError{line, static_cast<int>(u32())};
+            }
+            case PipelineErrorKind::Validation: {
+                const std::string_view field = str();
+                const std::string_view value = str();
+                return ValidationError{field, value, static_cast<std::size_t>(u64())};
+            }
+            case PipelineErrorKind::Processing: {
+                const std::string_view task = str();
+                return ProcessingError{task, str()};
+            }
+            case PipelineErrorKind::OutOfMemory: {
+                const std::string_view stage = intern_stage_name(str());
+                return OutOfMemoryError{stage, static_cast<std::size_t>(u64())};
+            }
+            case PipelineErrorKind::Cancelled: return Cancelled{intern_stage_name(str())};
+            case PipelineErrorKind::DeadlineExceeded: {
+                const std::string_view stage = intern_stage_name(str());
+                const auto budget = ns();
+                const auto overrun = ns();
+                return DeadlineExceeded{stage, budget, overrun, bytes(1) == std::string_view("\1", 1)};
+            }
+        }
+        std::unreachable(); // error_kind_from_code only yields valid kinds
+    };
+    static_assert(std::variant_size_v<PipelineError> == 7, "decode_binary_result handles every alternative");
+    PipelineError error = decode_error(*kind);
+    if (!ok) {
+        return std::nullopt;
+    }
+    std::visit([](auto& e) { e.stack = {}; }, error);
+    in = rest;
+    return std::expected<Result, PipelineError>(std::unexpect, std::move(error));
+}
+
+// Persistent result cache.
+// A cold start runs call_pipeline on every config. ResultCache keeps the
+// outcome per file on disk, keyed by (path, size, mtime, content hash), so a
+// restarted process skips the files that did not change. The cache file is
+// mapped on first use, and an entry is decoded only when it is looked up. A
+// matching size and mtime is a hit without reading the source. A changed
+// mtime with the same size costs one hash of the file, so a file that was
+// touched but not edited still hits.
+//
+// Flush() writes a new file next to the old one, fsyncs it and renames it
+// into place, so a crash leaves either the old or the new cache. A damaged
+// file fails its checksum and the cache starts out empty.
+//
+// Layout (little-endian, read with memcpy):
+//   CacheHeader | CacheEntry[entry_count] | blob (paths and encoded results)
+// Results are encoded with ResultRenderer::append_binary. Only errors that
+// depend on the file content are stored; I/O, memory, cancellation and
+// deadline errors are retried on the next run.
+struct CacheHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t entry_count;
+    std::uint64_t checksum; // FNV-1a over everything after the header
+    std::uint64_t total_size;
+};
+
+struct CacheEntry {
+    std::uint64_t path_offset;
+    std::uint64_t path_size;
+    std::uint64_t result_offset;
+    std::uint64_t result_size;
+    std::uint64_t source_size;
+    std::int64_t source_mtime;
+    std::uint64_t content_hash;
+};
+
+inline constexpr char kCacheMagic[8] = {'P', 'I', 'P', 'E', 'R', 'E', 'S', '\0'};
+inline constexpr std::uint32_t kCacheVersion = 2;
+
+// FNV-1a of the file's bytes; nullopt if it cannot be read.
+std::optional<std::uint64_t> hash_file_content(const std::string& filename) {
+    const int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return std::nullopt;
+    }
+    if (st.st_size == 0) {
+        ::close(fd);
+        return fnv1a64({});
+    }
+    const auto size = static_cast<std::size_t>(st.st_size);
+    void* addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        return std::nullopt;
+    }
+    const std::uint64_t hash = fnv1a64(std::string_view(static_cast<const char*>(addr), size));
+    ::munmap(addr, size);
+    return hash;
+}
+
+[[nodiscard]] bool is_cacheable(const std::expected<Result, PipelineError>& result) {
+    return result.has_value() || error_traits(result.error()).deterministic;
+}
+
+class ResultCache {
+public:
+    struct Stats {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        std::uint64_t hashed = 0; // lookups that had to hash the source
+    };
+
+    explicit ResultCache(std::string path) : path_(std::move(path)) {}
+
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+    ~ResultCache() { unmap(); }
+
+    // The cached result for `filename` as described by `stamp`, if still valid.
+    [[nodiscard]] std::optional<std::expected<Result, PipelineError>> Lookup(const std::string& filename,
+                                                                            const SourceStamp& stamp) {
+        if (auto it = pending_.find(filename); it != pending_.end()) {
+            return lookup_record(filename, stamp, it->second.entry, it->second.encoded, &it->second);
+        }
+        load();
+        if (auto it = index_.find(filename); it != index_.end()) {
+            const CacheEntry e = entry(it->second);
+            return lookup_record(filename, stamp, e, blob_.substr(e.result_offset, e.result_size), nullptr);
+        }
+        ++stats_.misses;
+        return std::nullopt;
+    }
+
+    // Records `result` for the file as it was when `stamp` was taken. Nothing
+    // is stored when the result is not cacheable or the file changed meanwhile.
+    void Store(const std::string& filename, const SourceStamp& stamp, const std::expected<Result, PipelineError>& result) {
+        if (!is_cacheable(result)) {
+            return;
+        }
+        const auto hash = hash_file_content(filename);
+        const auto now = stat_source(filename);
+        if (!hash || !now || now->size != stamp.size || now->mtime != stamp.mtime) {
+            return;
+        }
+        Pending& pending = pending_[filename];
+        pending.entry = CacheEntry{0, 0, 0, 0, stamp.size, stamp.mtime, *hash};
+        pending.encoded.clear();
+        ResultRenderer::append_binary(pending.encoded, result);
+    }
+
+    // Writes the cache atomically; pending entries replace stored ones.
+    [[nodiscard]] std::expected<void, PipelineError> Flush() {
+        if (pending_.empty()) {
+            return {};
+        }
+        load();
+        std::vector<CacheEntry> entries;
+        std::string blob;
+        const auto add = [&](std::string_view path, CacheEntry e, std::string_view encoded) {
+            e.path_offset = blob.size();
+            e.path_size = path.size();
+            blob += path;
+            e.result_offset = blob.size();
+            e.result_size = encoded.size();
+            blob += encoded;
+            entries.push_back(e);
+        };
+        for (const auto& [path, i] : index_) {
+            if (!pending_.contains(path)) {
+                const CacheEntry e = entry(i);
+                add(path, e, blob_.substr(e.result_offset, e.result_size));
+            }
+        }
+        for (const auto& [path, pending] : pending_) {
+            add(path, pending.entry, pending.encoded);
+        }
+
+        std::string body(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(CacheEntry));
+        body += blob;
+        CacheHeader header{};
+        std::memcpy(header.magic, kCacheMagic, sizeof(header.magic));
+        header.version = kCacheVersion;
+        header.entry_count = static_cast<std::uint32_t>(entries.size());
+        header.checksum = fnv1a64(body);
+        header.total_size = sizeof(CacheHeader) + body.size();
+
+        const std::string tmp_path = path_ + ".tmp." + std::to_string(::getpid());
+        if (!write_durably(tmp_path, header, body) || std::rename(tmp_path.c_str(), path_.c_str()) != 0) {
+            std::remove(tmp_path.c_str());
+            return std::unexpected(ConfigReadError{path_});
+        }
+        sync_parent_directory();
+        pending_.clear();
+        unmap();
+        loaded_ = false; // the next lookup maps the new file
+        return {};
+    }
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    struct Pending {
+        CacheEntry entry{};
+        std::string encoded;
+    };
+
+    std::optional<std::expected<Result, PipelineError>> lookup_record(const std::string& filename, const SourceStamp& stamp,
+                                                                      const CacheEntry& e, std::string_view encoded,
+                                                                      Pending* pending) {
+        if (e.source_size != stamp.size) {
+            ++stats_.misses;
+            return std::nullopt;
+        }
+        if (e.source_mtime != stamp.mtime) {
+            ++stats_.hashed;
+            if (hash_file_content(filename) != e.content_hash) {
+                ++stats_.misses;
+                return std::nullopt;
+            }
+            // Same content: remember the new mtime so the next run skips the hash.
+            if (pending == nullptr) {
+                pending = &pending_[filename];
+                pending->encoded.assign(encoded);
+            }
+            pending->entry = e;
+            pending->entry.source_mtime = stamp.mtime;
+            encoded = pending->encoded;
+        }
+        auto decoded = decode_binary_result(encoded);
+        if (decoded) {
+            ++stats_.hits;
+        } else {
+            ++stats_.misses;
+        }
+        return decoded;
+    }
+
+    // Maps the cache file on first use; a missing or damaged file leaves the cache empty.
+    void load() {
+        if (loaded_) {
+            return;
+        }
+        loaded_ = true;
+        const int fd = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(CacheHeader))) {
+            ::close(fd);
+            return;
+        }
+        size_ = static_cast<std::size_t>(st.st_size);
+        void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED) {
+            return;
+        }
+        base_ = static_cast<const char*>(addr);
+
+        CacheHeader header;
+        std::memcpy(&header, base_, sizeof(header));
+        const std::string_view body(base_ + sizeof(CacheHeader), size_ - sizeof(CacheHeader));
+        if (std::memcmp(header.magic, kCacheMagic, sizeof(kCacheMagic)) != 0 || header.version != kCacheVersion ||
+            header.total_size != size_ || header.entry_count > body.size() / sizeof(CacheEntry) ||
+            fnv1a64(body) != header.checksum) {
+            unmap();
+            return;
+        }
+        blob_ = body.substr(header.entry_count * sizeof(CacheEntry));
+        index_.reserve(header.entry_count);
+        for (std::size_t i = 0; i < header.entry_count; ++i) {
+            const CacheEntry e = entry(i);
+            if (!in_blob(blob_, e.path_offset, e.path_size) || !in_blob(blob_, e.result_offset, e.result_size)) {
+                index_.clear();
+                unmap();
+                return;
+            }
+            index_.emplace(blob_.substr(e.path_offset, e.path_size), i);
+        }
+    }
+
+    CacheEntry entry(std::size_t i) const {
+        CacheEntry e;
+        std::memcpy(&e, base_ + sizeof(CacheHeader) + i * sizeof(CacheEntry), sizeof(e));
+        return e;
+    }
+
+    static bool write_durably(const std::string& path, const CacheHeader& header, std::string_view body) {
+        const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            return false;
+        }
+        iovec iov[2] = {{const_cast<CacheHeader*>(&header), sizeof(header)},
+                        {const_cast<char*>(body.data()), body.size()}};
+        std::size_t remaining = sizeof(header) + body.size();
+        bool ok = true;
+        for (int first = 0; ok && remaining > 0;) {
+            const ssize_t written = ::writev(fd, iov + first, 2 - first);
+            if (written < 0) {
+                ok = errno == EINTR;
+                continue;
+            }
+            remaining -= static_cast<std::size_t>(written);
+            for (auto n = static_cast<std::size_t>(written); n > 0;) {
+                const std::size_t step = std::min(n, iov[first].iov_len);
+                iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + step;
+                iov[first].iov_len -= step;
+                n -= step;
+                if (iov[first].iov_len == 0) {
+                    ++first;
+                }
+            }
+        }
+        ok = ok && ::fsync(fd) == 0;
+        return ::close(fd) == 0 && ok;
+    }
+
+    // Makes the rename itself durable.
+    void sync_parent_directory() const {
+        const auto parent = std::filesystem::path(path_).parent_path();
+        const int fd = ::open(parent.empty() ? "." : parent.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd >= 0) {
+            ::fsync(fd);
+            ::close(fd);
+        }
+    }
+
+    void unmap() {
+        index_.clear();
+        blob_ = {};
+        if (base_ != nullptr) {
+            ::munmap(const_cast<char*>(base_), size_);
+            base_ = nullptr;
+        }
+        size_ = 0;
+    }
+
+    std::string path_;
+    bool loaded_ = false;
+    const char* base_ = nullptr;
+    std::size_t size_ = 0;
+    std::string_view blob_;
+    std::unordered_map<std::string_view, std::size_t> index_;
+    std::map<std::string, Pending, std::less<>> pending_;
+    Stats stats_;
+};
+
+// Serves unchanged files from `cache` and records the result of the others.
+[[nodiscard]] std::expected<Result, PipelineError> call_pipeline(const std::string& configfile, ResultCache& cache) {
+    const auto stamp = stat_source(configfile);
+    if (!stamp) {
+        return call_pipeline(configfile);
+    }
+    if (auto cached = cache.Lookup(configfile, *stamp)) {
+        return *std::move(cached);
+    }
+    auto result = call_pipeline(configfile);
+    cache.Store(configfile, *stamp, result);
+    return result;
+}
+
+// Local validation daemon.
+// Many processes on a host validate the same configs. ValidationDaemon serves
+// call_pipeline over a Unix domain socket from one process, so all of them
+// share its ResultCache. One epoll loop handles every connection: each wakeup
+// gathers the complete requests of all readable connections into one batch,
+// runs every distinct path in the batch once and queues the responses.
+//
+// Protocol (little-endian): each message is a u32 payload size and the payload.
+//   hello:    u32 kDaemonHelloId | u32 protocol version (first message each way)
+//   request:  u32 request id | path
+//   response: u32 request id | one ResultRenderer::append_binary record
+// The daemon closes a connection whose hello has another version. Paths are
+// resolved by the daemon, so clients should send absolute paths.
+inline constexpr std::size_t kMaxDaemonMessage = 64 * 1024;
+// A connection is not read while this much output waits for it (a client
+// that does not read its answers), and one wakeup reads at most kDaemonReadBudget.
+inline constexpr std::size_t kMaxDaemonPendingOutput = 1024 * 1024;
+inline constexpr std::size_t kDaemonReadBudget = 64 * 1024;
+inline constexpr std::uint32_t kDaemonProtocolVersion = 2;
+inline constexpr std::uint32_t kDaemonHelloId = 0xffffffff;
+
+void append_u32_le(std::string& out, std::uint32_t v) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out += static_cast<char>((v >> shift) & 0xff);
+    }
+}
+
+std::uint32_t load_u32_le(std::string_view bytes) {
+    std::uint32_t v = 0;
+    for (std::size_t i = 0; i < 4; ++i) {
+        v |= static_cast<std::uint32_t>(static_cast<unsigned char>(bytes[i])) << (8 * i);
+    }
+    return v;
+}
+
+void append_daemon_message(std::string& out, std::uint32_t id, std::string_view body) {
+    append_u32_le(out, static_cast<std::uint32_t>(4 + body.size()));
+    append_u32_le(out, id);
+    out += body;
+}
+
+enum class FrameStatus { Complete, Incomplete, Invalid };
+
+// Takes one message off the front of `in`, split into its id and body.
+FrameStatus next_daemon_message(std::string_view& in, std::uint32_t& id, std::string_view& body) {
+    if (in.size() < 4) {
+        return FrameStatus::Incomplete;
+    }
+    const std::uint32_t size = load_u32_le(in);
+    if (size < 4 || size > kMaxDaemonMessage) {
+        return FrameStatus::Invalid;
+    }
+    if (in.size() - 4 < size) {
+        return FrameStatus::Incomplete;
+    }
+    id = load_u32_le(in.substr(4));
+    body = in.substr(8, size - 4);
+    in.remove_prefix(4 + size);
+    return FrameStatus::Complete;
+}
+
+sockaddr_un unix_socket_address(const std::string& path) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.data(), std::min(path.size(), sizeof(addr.sun_path) - 1));
+    return addr;
+}
+
+class ValidationDaemon {
+public:
+    struct Stats {
+        std::uint64_t requests = 0;
+        std::uint64_t batches = 0;
+        std::uint64_t pipeline_runs = 0; // distinct paths run per batch
+    };
+
+    // Binds `socket_path` and opens the shared cache. A stale socket left by a
+    // daemon that died is replaced; a live daemon's socket or any other file
+    // at that path is an error.
+    [[nodiscard]] static std::expected<ValidationDaemon, PipelineError> Listen(const std::string& socket_path,
+                                                                               std::string cache_path) {
+        const sockaddr_un addr = unix_socket_address(socket_path);
+        if (socket_path.size() >= sizeof(addr.sun_path) || !remove_stale_socket(socket_path, addr)) {
+            return std::unexpected(ConfigReadError{socket_path});
+        }
+        ValidationDaemon daemon(socket_path, std::move(cache_path));
+        daemon.listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (daemon.listen_fd_ < 0 || ::bind(daemon.listen_fd_, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            ::listen(daemon.listen_fd_, SOMAXCONN) != 0) {
+            return std::unexpected(ConfigReadError{socket_path});
+        }
+        daemon.epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+        if (daemon.epoll_fd_ < 0 || !daemon.watch(daemon.listen_fd_, kListenKey, EPOLLIN)) {
+            return std::unexpected(ConfigReadError{socket_path});
+        }
+        return daemon;
+    }
+
+    ValidationDaemon(ValidationDaemon&& other) noexcept
+        : socket_path_(std::move(other.socket_path_)), cache_(std::move(other.cache_)),
+          listen_fd_(std::exchange(other.listen_fd_, -1)), epoll_fd_(std::exchange(other.epoll_fd_, -1)),
+          next_key_(other.next_key_), connections_(std::move(other.connections_)), stats_(other.stats_) {}
+
+    ValidationDaemon& operator=(ValidationDaemon&&) = delete;
+
+    ~ValidationDaemon() {
+        for (auto& [key, connection] : connections_) {
+            ::close(connection.fd);
+        }
+        if (listen_fd_ >= 0) {
+            ::close(listen_fd_);
+            ::unlink(socket_path_.c_str());
+        }
+        if (epoll_fd_ >= 0) {
+            ::close(epoll_fd_);
+        }
+    }
+
+    // Serves until `stop` is requested, then writes the cache to disk.
+    void Run(std::stop_token stop) {
+        const int wake_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        watch(wake_fd, kWakeKey, EPOLLIN);
+        const std::stop_callback on_stop(stop, [wake_fd] {
+            const std::uint64_t one = 1;
+            [[maybe_unused]] const auto written = ::write(wake_fd, &one, sizeof(one));
+        });
+
+        std::array<epoll_event, 64> events;
+        std::vector<Request> batch;
+        while (!stop.stop_requested()) {
+            const int ready = ::epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), -1);
+            if (ready < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+            for (int i = 0; i < ready; ++i) {
+                const std::uint64_t key = events[i].data.u64;
+                if (key == kListenKey) {
+                    accept_connections();
+                } else if (key != kWakeKey) {
+                    if ((events[i].events & (EPOLLOUT | EPOLLHUP | EPOLLERR)) != 0) {
+                        write_pending(key);
+                    }
+                    if ((events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) != 0) {
+                        read_requests(key, batch);
+                    }
+                }
+            }
+            if (!batch.empty()) {
+                serve(batch);
+                batch.clear();
+            }
+        }
+        ::close(wake_fd);
+        (void)cache_->Flush();
+    }
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    static constexpr std::uint64_t kListenKey = 0;
+    static constexpr std::uint64_t kWakeKey = 1;
+
+    struct Connection {
+        int fd = -1;
+        std::string in;
+        std::string out;
+        std::size_t out_sent = 0;
+        std::uint32_t events = EPOLLIN; // as registered with epoll
+        bool greeted = false;           // the client's hello was accepted
+        bool read_closed = false;       // EOF seen; closed once every answer is out
+        std::size_t unanswered = 0;     // requests in the current batch
+    };
+
+    struct Request {
+        std::uint64_t connection;
+        std::uint32_t id;
+        std::string path;
+    };
+
+    ValidationDaemon(std::string socket_path, std::string cache_path)
+        : socket_path_(std::move(socket_path)), cache_(std::make_unique<ResultCache>(std::move(cache_path))) {}
+
+    // True when nothing is left at `path`: it never existed, or it was a
+    // socket nobody listens on any more.
+    static bool remove_stale_socket(const std::string& path, const sockaddr_un& addr) {
+        struct stat st {};
+        if (::lstat(path.c_str(), &st) != 0) {
+            return errno == ENOENT;
+        }
+        if (!S_ISSOCK(st.st_mode)) {
+            return false;
+        }
+        const int probe = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (probe < 0) {
+            return false;
+        }
+        const bool refused = ::connect(probe, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 &&
+                             errno == ECONNREFUSED;
+        ::close(probe);
+        return refused && ::unlink(path.c_str()) == 0;
+    }
+
+    bool watch(int fd, std::uint64_t key, std::uint32_t events, int op = EPOLL_CTL_ADD) {
+        epoll_event event{};
+        event.events = events;
+        event.data.u64 = key;
+        return ::epoll_ctl(epoll_fd_, op, fd, &event) == 0;
+    }
+
+    void accept_connections() {
+        for (;;) {
+            const int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                return; // EAGAIN, or an error the next wakeup retries
+            }
+            const std::uint64_t key = next_key_++;
+            if (!watch(fd, key, EPOLLIN)) {
+                ::close(fd);
+                continue;
+            }
+            connections_[key].fd = fd;
+        }
+    }
+
+    void read_requests(std::uint64_t key, std::vector<Request>& batch) {
+        auto it = connections_.find(key);
+        if (it == connections_.end()) {
+            return;
+        }
+        Connection& connection = it->second;
+        char buffer[16 * 1024];
+        bool open = true;
+        const bool backlogged = connection.out.size() - connection.out_sent >= kMaxDaemonPendingOutput;
+        for (std::size_t budget = backlogged ? 0 : kDaemonReadBudget; budget > 0;) {
+            const ssize_t n = ::read(connection.fd, buffer, std::min(sizeof(buffer), budget));
+            if (n > 0) {
+                connection.in.append(buffer, static_cast<std::size_t>(n));
+                budget -= static_cast<std::size_t>(n);
+                continue;
+            }
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            open = n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+            connection.read_closed = n == 0;
+            break;
+        }
+
+        std::string_view in = connection.in;
+        std::uint32_t id = 0;
+        std::string_view path;
+        FrameStatus status = FrameStatus::Incomplete;
+        while ((status = next_daemon_message(in, id, path)) == FrameStatus::Complete) {
+            if (!connection.greeted) {
+                if (id != kDaemonHelloId || path.size() != 4 || load_u32_le(path) != kDaemonProtocolVersion) {
+                    status = FrameStatus::Invalid;
+                    break;
+                }
+                connection.greeted = true;
+                std::string version;
+                append_u32_le(version, kDaemonProtocolVersion);
+                append_daemon_message(connection.out, kDaemonHelloId, version);
+                continue;
+            }
+            batch.push_back({key, id, std::string(path)});
+            ++connection.unanswered;
+        }
+        connection.in.erase(0, connection.in.size() - in.size());
+        if (status == FrameStatus::Invalid || (!open && !connection.read_closed)) {
+            close_connection(key);
+        } else if (connection.out.size() > connection.out_sent) {
+            write_pending(key); // the hello reply
+        } else if (connection.read_closed && connection.unanswered == 0) {
+            close_connection(key); // half-closed with nothing left to answer
+        } else {
+            update_interest(key, connection);
+        }
+    }
+
+    void serve(const std::vector<Request>& batch) {
+        ++stats_.batches;
+        stats_.requests += batch.size();
+        std::unordered_map<std::string_view, std::string> records;
+        for (const Request& request : batch) {
+            auto [record, inserted] = records.try_emplace(request.path);
+            if (inserted) {
+                ++stats_.pipeline_runs;
+                ResultRenderer::append_binary(record->second, call_pipeline(request.path, *cache_));
+            }
+            if (auto it = connections_.find(request.connection); it != connections_.end()) {
+                append_daemon_message(it->second.out, request.id, record->second);
+                --it->second.unanswered;
+            }
+        }
+        // write_pending may close the connection, so collect the keys first.
+        std::vector<std::uint64_t> ready;
+        for (const auto& [key, connection] : connections_) {
+            if (connection.out.size() > connection.out_sent) {
+                ready.push_back(key);
+            }
+        }
+        for (const std::uint64_t key : ready) {
+            write_pending(key);
+        }
+    }
+
+    void write_pending(std::uint64_t key) {
+        auto it = connections_.find(key);
+        if (it == connections_.end()) {
+            return;
+        }
+        Connection& connection = it->second;
+        while (connection.out_sent < connection.out.size()) {
+            const ssize_t n = ::send(connection.fd, connection.out.data() + connection.out_sent,
+                                     connection.out.size() - connection.out_sent, MSG_NOSIGNAL);
+            if (n >= 0) {
+                connection.out_sent += static_cast<std::size_t>(n);
+            } else if (errno != EINTR) {
+                if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                    close_connection(key);
+                    return;
+                }
+                break;
+            }
+        }
+        if (connection.out_sent == connection.out.size()) {
+            connection.out.clear();
+            connection.out_sent = 0;
+            if (connection.read_closed && connection.unanswered == 0) {
+                close_connection(key); // every answer is out
+                return;
+            }
+        } else if (connection.out_sent >= kMaxDaemonPendingOutput) {
+            connection.out.erase(0, connection.out_sent); // keep a slow reader's buffer bounded
+            connection.out_sent = 0;
+        }
+        update_interest(key, connection);
+    }
+
+    // Reads until EOF unless too much output is pending, and waits for
+    // writability while any is. A client that stops reading thus stops being
+    // read, and its own writes block.
+    void update_interest(std::uint64_t key, Connection& connection) {
+        const std::size_t pending = connection.out.size() - connection.out_sent;
+        const bool readable = !connection.read_closed && pending < kMaxDaemonPendingOutput;
+        const std::uint32_t events = (readable ? std::uint32_t{EPOLLIN} : 0u) | (pending > 0 ? std::uint32_t{EPOLLOUT} : 0u);
+        if (events != connection.events) {
+            connection.events = events;
+            watch(connection.fd, key, events, EPOLL_CTL_MOD);
+        }
+    }
+
+    void close_connection(std::uint64_t key) {
+        if (auto it = connections_.find(key); it != connections_.end()) {
+            ::close(it->second.fd); // also removes it from the epoll set
+            connections_.erase(it);
+        }
+    }
+
+    std::string socket_path_;
+    std::unique_ptr<ResultCache> cache_;
+    int listen_fd_ = -1;
+    int epoll_fd_ = -1;
+    std::uint64_t next_key_ = 2; // after kListenKey and kWakeKey
+    std::unordered_map<std::uint64_t, Connection> connections_;
+    Stats stats_;
+};
+
+class DaemonClient {
+public:
+    [[nodiscard]] static std::expected<DaemonClient, PipelineError> Connect(const std::string& socket_path) {
+        const sockaddr_un addr = unix_socket_address(socket_path);
+        DaemonClient client;
+        client.fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (client.fd_ < 0 || ::connect(client.fd_, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            !client.handshake()) {
+            return std::unexpected(ConfigReadError{socket_path});
+        }
+        return client;
+    }
+
+    DaemonClient(DaemonClient&& other) noexcept : fd_(std::exchange(other.fd_, -1)), next_id_(other.next_id_) {}
+    DaemonClient& operator=(DaemonClient&&) = delete;
+
+    ~DaemonClient() {
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    // Sends all paths and returns their results in order. Replies are read
+    // while the request is still being sent: the daemon stops reading once
+    // kMaxDaemonPendingOutput of replies are queued, so a large batch would
+    // otherwise deadlock. A transport failure is a ConfigReadError for "<daemon>".
+    [[nodiscard]] std::expected<std::vector<std::expected<Result, PipelineError>>, PipelineError> Validate(
+        const std::vector<std::string>& paths) {
+        std::string request;
+        const std::uint32_t first_id = next_id_;
+        for (const auto& path : paths) {
+            append_daemon_message(request, next_id_++, path);
+        }
+
+        std::vector<std::expected<Result, PipelineError>> results;
+        results.reserve(paths.size());
+        std::size_t sent = 0;
+        while (results.size() < paths.size()) {
+            std::string_view in = buffer_;
+            std::uint32_t id = 0;
+            std::string_view body;
+            FrameStatus status = FrameStatus::Incomplete;
+            while (results.size() < paths.size() && (status = next_daemon_message(in, id, body)) == FrameStatus::Complete) {
+                auto decoded = decode_binary_result(body);
+                if (id != first_id + results.size() || !decoded) {
+                    return std::unexpected(ConfigReadError{"<daemon>"});
+                }
+                results.push_back(*std::move(decoded));
+            }
+            buffer_.erase(0, buffer_.size() - in.size());
+            if (results.size() == paths.size()) {
+                break;
+            }
+            if (status == FrameStatus::Invalid) {
+                return std::unexpected(ConfigReadError{"<daemon>"});
+            }
+            pollfd pfd{fd_, static_cast<short>(POLLIN | (sent < request.size() ? POLLOUT : 0)), 0};
+            if (::poll(&pfd, 1, -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return std::unexpected(ConfigReadError{"<daemon>"});
+            }
+            if ((pfd.revents & POLLOUT) != 0) {
+                const ssize_t n = ::send(fd_, request.data() + sent, request.size() - sent, MSG_DONTWAIT | MSG_NOSIGNAL);
+                if (n < 0 && errno != EAGAIN && errno != EINTR) {
+                    return std::unexpected(ConfigReadError{"<daemon>"});
+                }
+                sent += n > 0 ? static_cast<std::size_t>(n) : 0;
+            }
+            if ((pfd.revents & (POLLIN | POLLHUP | POLLERR)) != 0 && !read_some()) {
+                return std::unexpected(ConfigReadError{"<daemon>"});
+            }
+        }
+        return results;
+    }
+
+private:
+    DaemonClient() = default;
+
+    // Exchanges hellos; false when the daemon speaks another protocol version.
+    bool handshake() {
+        std::string version;
+        append_u32_le(version, kDaemonProtocolVersion);
+        std::string hello;
+        append_daemon_message(hello, kDaemonHelloId, version);
+        if (!write_all(hello)) {
+            return false;
+        }
+        for (;;) {
+            std::string_view in = buffer_;
+            std::uint32_t id = 0;
+            std::string_view body;
+            const FrameStatus status = next_daemon_message(in, id, body);
+            if (status == FrameStatus::Complete) {
+                const bool ok = id == kDaemonHelloId && body == version;
+                buffer_.erase(0, buffer_.size() - in.size());
+                return ok;
+            }
+            if (status == FrameStatus::Invalid || !read_some()) {
+                return false;
+            }
+        }
+    }
+
+    bool write_all(std::string_view bytes) {
+        for (std::size_t sent = 0; sent < bytes.size();) {
+            const ssize_t n = ::write(fd_, bytes.data() + sent, bytes.size() - sent);
+            if (n < 0 && errno != EINTR) {
+                return false;
+            }
+            sent += n > 0 ? static_cast<std::size_t>(n) : 0;
+        }
+        return true;
+    }
+
+    bool read_some() {
+        char chunk[16 * 1024];
+        const ssize_t n = ::read(fd_, chunk, sizeof(chunk));
+        if (n <= 0 && !(n < 0 && errno == EINTR)) {
+            return false;
+        }
+        buffer_.append(chunk, static_cast<std::size_t>(std::max<ssize_t>(n, 0)));
+        return true;
+    }
+
+    int fd_ = -1;
+    std::uint32_t next_id_ = 0;
+    std::string buffer_;
+};
+
+struct LoadTestReport {
+    std::uint64_t requests = 0;
+    std::uint64_t failures = 0; // transport failures, not pipeline errors
+    double seconds = 0.0;
+    double requests_per_s = 0.0;
+    double p50_us = 0.0;
+    double p99_us = 0.0;
+};
+
+// Runs `connections` clients against the daemon for `duration`. Each client
+// sends `batch` paths per round trip, cycling through `files`; a request's
+// latency is the round trip of its batch.
+LoadTestReport run_daemon_load_test(const std::string& socket_path, const std::vector<std::string>& files,
+                                    unsigned connections, std::chrono::milliseconds duration, std::size_t batch = 16) {
+    using Clock = std::chrono::steady_clock;
+    std::vector<std::vector<double>> latencies(connections);
+    std::atomic<std::uint64_t> failures{0};
+    const auto start = Clock::now();
+    const auto end = start + duration;
+    {
+        std::vector<std::jthread> clients;
+        for (unsigned c = 0; c < connections; ++c) {
+            clients.emplace_back([&, c] {
+                auto client = DaemonClient::Connect(socket_path);
+                if (!client) {
+                    failures.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                std::vector<std::string> paths(batch);
+                for (std::size_t next = c; Clock::now() < end;) {
+                    for (auto& path : paths) {
+                        path = files[next++ % files.size()];
+                    }
+                    const auto sent = Clock::now();
+                    if (!client->Validate(paths)) {
+                        failures.fetch_add(1, std::memory_order_relaxed);
+                        return;
+                    }
+                    const double us = std::chrono::duration<double, std::micro>(Clock::now() - sent).count();
+                    latencies[c].insert(latencies[c].end(), batch, us);
+                }
+            });
+        }
+    }
+
+    LoadTestReport report;
+    report.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::vector<double> all;
+    for (const auto& l : latencies) {
+        all.insert(all.end(), l.begin(), l.end());
+    }
+    report.requests = all.size();
+    report.failures = failures.load();
+    report.requests_per_s = static_cast<double>(all.size()) / report.seconds;
+    if (!all.empty()) {
+        const auto percentile = [&all](double p) {
+            const auto k = static_cast<std::size_t>(p * static_cast<double>(all.size() - 1));
+            std::nth_element(all.begin(), all.begin() + static_cast<std::ptrdiff_t>(k), all.end());
+            return all[k];
+        };
+        report.p50_us = percentile(0.50);
+        report.p99_us = percentile(0.99);
+    }
+    return report;
+}
+
+void print_load_test_json(const LoadTestReport& r, std::ostream& os) {
+    os << "{\"requests\":" << r.requests << ",\"failures\":" << r.failures << ",\"seconds\":" << r.seconds
+       << ",\"requests_per_s\":" << r.requests_per_s << ",\"p50_us\":" << r.p50_us << ",\"p99_us\":" << r.p99_us << "}"
+       << std::endl;
+}
+
+// Shared-memory result board.
+// A publisher writes each file's result into a POSIX shared-memory segment,
+// and any number of local reader processes look results up without locks
+// and without calling into the publisher. The segment is a fixed-size,
+// open-addressed hash table of slots keyed by path. Each slot is guarded by a
+// seqlock: the writer makes the sequence odd, rewrites the slot, then makes
+// it even again. A reader decodes the record straight out of the mapping and
+// retries if the sequence changed in the meantime. Decoding is bounds-checked,
+// so a torn read is harmless and just retried. There is one publisher per board.
+// A slot that stays odd (a publisher that died mid-write) reads as a miss
+// after kBoardReadAttempts.
+inline constexpr char kBoardMagic[8] = {'P', 'I', 'P', 'E', 'B', 'R', 'D', '\0'};
+inline constexpr std::uint32_t kBoardVersion = 2;
+inline constexpr std::size_t kBoardPathBytes = 256;
+inline constexpr std::size_t kBoardRecordBytes = 512; // the largest encoded result is under 300 bytes
+inline constexpr int kBoardReadAttempts = 4096;
+
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "the seqlock lives in shared memory");
+
+struct alignas(64) BoardHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t slot_count; // a power of two
+    std::uint64_t slot_size;
+};
+
+struct alignas(64) BoardSlot {
+    std::atomic<std::uint32_t> sequence; // 0: never written, odd: being written
+    std::uint32_t record_size;
+    std::uint64_t path_hash;
+    std::uint32_t path_size;
+    char path[kBoardPathBytes];
+    char record[kBoardRecordBytes];
+};
+
+class ResultBoard {
+public:
+    // Creates the segment `name` ("/something") for publishing. An old board
+    // of that name is unlinked, not truncated: readers that still map it keep
+    // its last contents until they Open the name again.
+    [[nodiscard]] static std::expected<ResultBoard, PipelineError> Create(const std::string& name, std::size_t capacity) {
+        const auto slots = static_cast<std::uint32_t>(std::bit_ceil(std::max<std::size_t>(capacity * 2, 8)));
+        const std::size_t size = sizeof(BoardHeader) + slots * sizeof(BoardSlot);
+        ::shm_unlink(name.c_str());
+        const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            return std::unexpected(ConfigReadError{name});
+        }
+        if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            ::close(fd);
+            ::shm_unlink(name.c_str());
+            return std::unexpected(ConfigReadError{name});
+        }
+        void* addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED) {
+            return std::unexpected(ConfigReadError{name});
+        }
+        ResultBoard board(static_cast<char*>(addr), size, slots, true);
+        BoardHeader header{};
+        std::memcpy(header.magic, kBoardMagic, sizeof(header.magic));
+        header.version = kBoardVersion;
+        header.slot_count = slots;
+        header.slot_size = sizeof(BoardSlot);
+        std::memcpy(board.base_, &header, sizeof(header));
+        return board;
+    }
+
+    // Maps an existing board read-only.
+    [[nodiscard]] static std::expected<ResultBoard, PipelineError> Open(const std::string& name) {
+        const int fd = ::shm_open(name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+        if (fd < 0) {
+            return std::unexpected(ConfigReadError{name});
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(BoardHeader))) {
+            ::close(fd);
+            return std::unexpected(ConfigParseError{"truncated result board", 0});
+        }
+        const auto size = static_cast<std::size_t>(st.st_size);
+        void* addr = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED) {
+            return std::unexpected(ConfigReadError{name});
+        }
+        BoardHeader header;
+        std::memcpy(&header, addr, sizeof(header));
+        ResultBoard board(static_cast<char*>(addr), size, header.slot_count, false);
+        if (std::memcmp(header.magic, kBoardMagic, sizeof(kBoardMagic)) != 0 || header.version != kBoardVersion ||
+            header.slot_size != sizeof(BoardSlot) || !std::has_single_bit(header.slot_count) ||
+            sizeof(BoardHeader) + std::size_t{header.slot_count} * sizeof(BoardSlot) > size) {
+            return std::unexpected(ConfigParseError{"unsupported result board", 0});
+        }
+        return board;
+    }
+
+    static void Remove(const std::string& name) { ::shm_unlink(name.c_str()); }
+
+    ResultBoard(ResultBoard&& other) noexcept
+        : base_(std::exchange(other.base_, nullptr)), size_(other.size_), mask_(other.mask_), writable_(other.writable_) {}
+    ResultBoard& operator=(ResultBoard&&) = delete;
+
+    ~ResultBoard() {
+        if (base_ != nullptr) {
+            ::munmap(base_, size_);
+        }
+    }
+
+    // Publishes or replaces the result for `path`. False when the path or
+    // record does not fit a slot, the board is full, or it was opened read-only.
+    bool Publish(std::string_view path, const std::expected<Result, PipelineError>& result) {
+        std::string record;
+        ResultRenderer::append_binary(record, result);
+        if (!writable_ || path.size() > kBoardPathBytes || record.size() > kBoardRecordBytes) {
+            return false;
+        }
+        const std::uint64_t hash = fnv1a64(path);
+        for (std::size_t probe = 0; probe <= mask_; ++probe) {
+            BoardSlot& slot = this->slot(hash + probe);
+            const std::uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+            if (sequence != 0 && !holds(slot, hash, path)) {
+                continue;
+            }
+            slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.path_hash = hash;
+            slot.path_size = static_cast<std::uint32_t>(path.size());
+            std::memcpy(slot.path, path.data(), path.size());
+            slot.record_size = static_cast<std::uint32_t>(record.size());
+            std::memcpy(slot.record, record.data(), record.size());
+            slot.sequence.store(sequence + 2, std::memory_order_release);
+            return true;
+        }
+        return false;
+    }
+
+    // The published result for `path`, decoded in place; lock-free. A slot
+    // that does not settle within kBoardReadAttempts reads is a miss.
+    [[nodiscard]] std::optional<std::expected<Result, PipelineError>> Lookup(std::string_view path) const {
+        const std::uint64_t hash = fnv1a64(path);
+        for (std::size_t probe = 0; probe <= mask_; ++probe) {
+            const BoardSlot& slot = this->slot(hash + probe);
+            for (int attempt = 0;; ++attempt) {
+                if (attempt == kBoardReadAttempts) {
+                    return std::nullopt; // a writer that never finished
+                }
+                const std::uint32_t before = slot.sequence.load(std::memory_order_acquire);
+                if (before == 0) {
+                    return std::nullopt; // probing reached a never-used slot
+                }
+                if ((before & 1) != 0) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                const bool match = holds(slot, hash, path);
+                std::optional<std::expected<Result, PipelineError>> decoded;
+                if (match) {
+                    std::string_view record(slot.record, std::min<std::size_t>(slot.record_size, kBoardRecordBytes));
+                    decoded = decode_binary_result(record);
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.sequence.load(std::memory_order_relaxed) != before) {
+                    continue; // written meanwhile: read again
+                }
+                if (match) {
+                    return decoded;
+                }
+                break;
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::size_t capacity() const { return mask_ + 1; }
+
+private:
+    ResultBoard(char* base, std::size_t size, std::uint32_t slots, bool writable)
+        : base_(base), size_(size), mask_(slots == 0 ? 0 : slots - 1), writable_(writable) {}
+
+    BoardSlot& slot(std::uint64_t index) const {
+        return *reinterpret_cast<BoardSlot*>(base_ + sizeof(BoardHeader) + (index & mask_) * sizeof(BoardSlot));
+    }
+
+    static bool holds(const BoardSlot& slot, std::uint64_t hash, std::string_view path) {
+        return slot.path_hash == hash && slot.path_size == path.size() && std::memcmp(slot.path, path.data(), path.size()) == 0;
+    }
+
+    char* base_ = nullptr;
+    std::size_t size_ = 0;
+    std::size_t mask_ = 0;
+    bool writable_ = false;
+};
+
+// Coverage-guided fuzzing support.
+// call_pipeline_in_memory runs the three stages on a buffer, so a fuzzer can
+// drive them without touching the file system. Besides crashes, the harness
+// flags inputs whose time or allocated bytes per input byte exceed a limit,
+// which catches accidentally quadratic parsing or validation.
+[[nodiscard]] std::expected<Result, PipelineError> call_pipeline_in_memory(std::string_view content) {
+    return guard_allocations("call_pipeline_in_memory", [content] {
+        return ParseConfig(std::string(content), "<memory>")
+           .and_then([](const Config& cfg) { return ValidateData(cfg); })
+           .and_then([](const ValidatedData& vd) { return ProcessData(vd); });
+    });
+}
+
+struct FuzzLimits {
+    double max_ns_per_byte = 2000.0;
+    std::chrono::nanoseconds time_slack = std::chrono::milliseconds(5);
+    double max_alloc_bytes_per_byte = 32.0;
+    std::uint64_t alloc_slack = 64 * 1024;
+};
+
+struct FuzzReport {
+    std::expected<Result, PipelineError> result;
+    std::chrono::nanoseconds elapsed{};
+    std::uint64_t allocated_bytes = 0;
+    bool too_slow = false;
+    bool too_much_memory = false;
+};
+
+[[nodiscard]] FuzzReport run_fuzz_input(std::string_view input, const FuzzLimits& limits = {}) {
+    const AllocationScope allocations;
+    const auto start = std::chrono::steady_clock::now();
+    auto result = call_pipeline_in_memory(input);
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    const std::uint64_t allocated = allocations.stats().bytes;
+
+    const auto bytes = static_cast<double>(input.size());
+    FuzzReport report{std::move(result), elapsed, allocated};
+    report.too_slow = elapsed > limits.time_slack &&
+                      static_cast<double>((elapsed - limits.time_slack).count()) > limits.max_ns_per_byte * bytes;
+    report.too_much_memory = allocated > limits.alloc_slack &&
+                             static_cast<double>(allocated - limits.alloc_slack) > limits.max_alloc_bytes_per_byte * bytes;
+    return report;
+}
+
+#if defined(PIPELINE_FUZZ)
+// Limits can be tuned per run, e.g. PIPELINE_FUZZ_MAX_NS_PER_BYTE=500.
+FuzzLimits fuzz_limits_from_env() {
+    FuzzLimits limits;
+    if (const char* v = std::getenv("PIPELINE_FUZZ_MAX_NS_PER_BYTE")) {
+        limits.max_ns_per_byte = std::strtod(v, nullptr);
+    }
+    if (const char* v = std::getenv("PIPELINE_FUZZ_MAX_ALLOC_PER_BYTE")) {
+        limits.max_alloc_bytes_per_byte = std::strtod(v, nullptr);
+    }
+    return limits;
+}
+
+// libFuzzer entry point; AFL++ builds the same harness with -fsanitize=fuzzer.
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size) {
+    static const FuzzLimits limits = fuzz_limits_from_env();
+    g_debug_logging.store(false, std::memory_order_relaxed);
+
+    const FuzzReport report = run_fuzz_input(std::string_view(reinterpret_cast<const char*>(data), size), limits);
+    if (report.too_slow || report.too_much_memory) {
+        std::fprintf(stderr, "Algorithmic slowdown on %zu-byte input: %lld ns, %llu bytes allocated\n", size,
+                     static_cast<long long>(report.elapsed.count()),
+                     static_cast<unsigned long long>(report.allocated_bytes));
+        std::abort(); // makes the fuzzer save the input as a crash
+    }
+    return 0;
+}
+#endif
+
+// Hardware performance counters for the benchmark harness.
+// PerfCounters opens one counter per event for the calling thread (and the
+// threads it starts) through perf_event_open. Events the CPU, kernel or
+// container does not allow are left out; with none at all the benchmarks
+// report wall-clock time only. Counts are scaled when the kernel had to
+// multiplex the counters.
+class PerfCounters {
+public:
+    static constexpr std::size_t kCount = 5;
+    static constexpr std::array<std::string_view, kCount> kNames = {
+        "cycles", "instructions", "branch_misses", "l1d_read_misses", "llc_read_misses",
+    };
+    using Counts = std::array<std::optional<double>, kCount>;
+
+    PerfCounters() {
+        constexpr auto cache_miss = [](std::uint64_t cache) {
+            return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        };
+        const std::array<std::pair<std::uint32_t, std::uint64_t>, kCount> events = {{
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_L1D)},
+            {PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_LL)},
+        }};
+        for (std::size_t i = 0; i < kCount; ++i) {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = events[i].first;
+            attr.config = events[i].second;
+            attr.disabled = 1;
+            attr.inherit = 1; // include the parallel scan workers
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            fds_[i] = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+            if (fds_[i] < 0 && first_error_ == 0) {
+                first_error_ = errno;
+            }
+        }
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters() {
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+    }
+
+    bool available() const {
+        return std::any_of(fds_.begin(), fds_.end(), [](int fd) { return fd >= 0; });
+    }
+
+    // "available", or why not, e.g. "unavailable: Permission denied".
+    std::string status() const {
+        if (available()) {
+            return "available";
+        }
+        return std::string("unavailable: ") + std::strerror(first_error_);
+    }
+
+    void start() {
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+    }
+
+    // The counts since start(); nullopt for counters that are missing or never ran.
+    Counts stop() {
+        Counts counts;
+        for (std::size_t i = 0; i < kCount; ++i) {
+            if (fds_[i] < 0) {
+                continue;
+            }
+            ::ioctl(fds_[i], PERF_EVENT_IOC_DISABLE, 0);
+            std::uint64_t values[3] = {}; // value, time enabled, time running
+            if (::read(fds_[i], values, sizeof(values)) == static_cast<ssize_t>(sizeof(values)) && values[2] > 0) {
+                counts[i] = static_cast<double>(values[0]) * static_cast<double>(values[1]) / static_cast<double>(values[2]);
+            }
+        }
+        return counts;
+    }
+
+private:
+    std::array<int, kCount> fds_{};
+    int first_error_ = 0;
+};
+
+// Shared by all benchmarks; opened on first use.
+PerfCounters& benchmark_counters() {
+    static PerfCounters counters;
+    return counters;
+}
+
+// Micro-benchmark harness: ./a.out --bench [suite]
+// Each benchmark is repeated, doubling the iteration count until a run takes
+// long enough to time reliably. Results are printed as one JSON document.
+struct BenchmarkResult {
+    std::string name;
+    std::uint64_t iterations = 0;
+    double ns_per_op = 0.0;
+    double mb_per_s = 0.0; // 0 when the benchmark has no byte count
+    PerfCounters::Counts counters_per_op{};
+};
+
+// Keeps the compiler from discarding a benchmarked computation.
+template<class T>
+void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+template<class F>
+[[nodiscard]] BenchmarkResult run_benchmark(std::string name, std::size_t bytes_per_op, F&& op) {
+    using Clock = std::chrono::steady_clock;
+    constexpr auto kMinRunTime = std::chrono::milliseconds(100);
+    do_not_optimize(op()); // warm-up
+
+    PerfCounters& counters = benchmark_counters();
+    for (std::uint64_t iterations = 1;; iterations *= 2) {
+        counters.start();
+        const auto start = Clock::now();
+        for (std::uint64_t i = 0; i < iterations; ++i) {
+            do_not_optimize(op());
+            asm volatile("" : : : "memory"); // inputs may have changed: no hoisting
+        }
+        const auto elapsed = Clock::now() - start;
+        PerfCounters::Counts counts = counters.stop();
+        if (elapsed >= kMinRunTime || iterations >= (std::uint64_t{1} << 32)) {
+            const double ns = std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iterations);
+            const double mb_per_s = bytes_per_op == 0 ? 0.0 : static_cast<double>(bytes_per_op) / ns * 1e9 / 1e6;
+            for (auto& count : counts) {
+                if (count) {
+                    *count /= static_cast<double>(iterations);
+                }
+            }
+            return {std::move(name), iterations, ns, mb_per_s, counts};
+        }
+    }
+}
+
+// Counter values are per operation; counters that are unavailable are omitted.
+void print_benchmarks_json(const std::vector<BenchmarkResult>& results, std::ostream& os) {
+    os << "{\"perf_counters\":\"" << benchmark_counters().status() << "\",\"benchmarks\":[";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        os << (i == 0 ? "\n" : ",\n") << "  {\"name\":\"" << r.name << "\",\"iterations\":" << r.iterations
+           << ",\"ns_per_op\":" << r.ns_per_op << ",\"mb_per_s\":" << r.mb_per_s;
+        bool any_counter = false;
+        for (std::size_t c = 0; c < PerfCounters::kCount; ++c) {
+            if (r.counters_per_op[c]) {
+                os << (any_counter ? "," : ",\"counters\":{") << '"' << PerfCounters::kNames[c] << "\":" << *r.counters_per_op[c];
+                any_counter = true;
+            }
+        }
+        os << (any_counter ? "}}" : "}");
+    }
+    os << "\n]}" << std::endl;
+}
+
+// Compile-time regex rules against std::regex and, for literal patterns,
+// plain find. The text is config-like lines with the only match at the end.
+std::vector<BenchmarkResult> run_regex_benchmarks() {
+    std::string text;
+    while (text.size() < 64 * 1024) {
+        text += "key_" + std::to_string(text.size()) + " = some_reasonably_long_value\n";
+    }
+    text += "secret_12345 invalid_field\n";
+    const std::string_view view = text;
+
+    const std::regex literal_re("invalid_field");
+    const std::regex class_re("secret_[0-9]+");
+    std::vector<BenchmarkResult> results;
+    results.push_back(run_benchmark("regex/literal/find", text.size(), [view] {
+        return view.find("invalid_field");
+    }));
+    results.push_back(run_benchmark("regex/literal/compile_time", text.size(), [view] {
+        return CompiledRegex<"invalid_field">::search(view);
+    }));
+    results.push_back(run_benchmark("regex/literal/std_regex", text.size(), [&text, &literal_re] {
+        return std::regex_search(text, literal_re);
+    }));
+    results.push_back(run_benchmark("regex/class/compile_time", text.size(), [view] {
+        return CompiledRegex<"secret_[0-9]+">::search(view);
+    }));
+    results.push_back(run_benchmark("regex/class/std_regex", text.size(), [&text, &class_re] {
+        return std::regex_search(text, class_re);
+    }));
+    return results;
+}
+
+// Inline error payloads against the same fields held in std::string. Bytes
+// per op is the object size, so mb_per_s for copies is the copy bandwidth.
+std::vector<BenchmarkResult> run_error_benchmarks() {
+    struct HeapValidationError {
+        std::string field_name;
+        std::string invalid_value;
+        std::size_t offset = std::string::npos;
+        CapturedStack stack = CapturedStack::sample();
+    };
+    using HeapPipelineError = std::variant<HeapValidationError, OutOfMemoryError>;
+    const std::string field = "invalid_field";
+    const std::string value = "contains a disallowed value";
+
+    const PipelineError inline_error = ValidationError{field, value, 42};
+    const HeapPipelineError heap_error = HeapValidationError{field, value, 42};
+    std::vector<BenchmarkResult> results;
+    results.push_back(run_benchmark("errors/construct/inline", sizeof(PipelineError), [&] {
+        return PipelineError(ValidationError{field, value, 42});
+    }));
+    results.push_back(run_benchmark("errors/construct/std_string", sizeof(HeapPipelineError), [&] {
+        return HeapPipelineError(HeapValidationError{field, value, 42});
+    }));
+    results.push_back(run_benchmark("errors/copy/inline", sizeof(PipelineError), [&] {
+        return inline_error;
+    }));
+    results.push_back(run_benchmark("errors/copy/std_string", sizeof(HeapPipelineError), [&] {
+        return heap_error;
+    }));
+
+    // Classification: the error-domain table against a visit over the variant.
+    const PipelineError mixed[] = {ConfigReadError{"a.conf"}, ValidationError{field, value, 42}, Cancelled{"ValidateData"},
+                                   ProcessingError{"Data Processing", "too short"}};
+    std::size_t next = 0;
+    results.push_back(run_benchmark("errors/classify/table", 0, [&] {
+        next = (next + 1) % std::size(mixed);
+        return is_retryable(mixed[next]);
+    }));
+    results.push_back(run_benchmark("errors/classify/visit", 0, [&] {
+        next = (next + 1) % std::size(mixed);
+        return std::visit(Overloaded {
+            [](const ConfigReadError&) { return true; },
+            [](const OutOfMemoryError&) { return true; },
+            [](const DeadlineExceeded&) { return true; },
+            [](const auto&) { return false; },
+        }, mixed[next]);
+    }));
+    return results;
+}
+
+// Each stage on its own, then the whole pipeline down each outcome, so the
+// perf counters show where an error path spends its cycles and misses. Every
+// "path" benchmark runs all three stages; only the read error has to come in
+// through call_pipeline, since an in-memory buffer cannot fail to open.
+std::vector<BenchmarkResult> run_stage_benchmarks() {
+    std::string content;
+    while (content.size() < 16 * 1024) {
+        content += "valid_data_content key = value\n";
+    }
+    const Config config{content};
+    const ValidatedData validated{content};
+    const std::string too_short = "short";
+    const std::string malformed = content + "malformed";
+    const std::string invalid = content + "invalid_field";
+    const std::string missing = "this_file_should_not_exist.txt";
+
+    std::vector<BenchmarkResult> results;
+    results.push_back(run_benchmark("stages/ParseConfig", content.size(), [&] {
+        return ParseConfig(content, "<memory>").has_value();
+    }));
+    results.push_back(run_benchmark("stages/ValidateData", content.size(), [&] {
+        return ValidateData(config).has_value();
+    }));
+    results.push_back(run_benchmark("stages/ProcessData", 0, [&] {
+        return ProcessData(validated).has_value();
+    }));
+    results.push_back(run_benchmark("stages/path/Result", content.size(), [&] {
+        return call_pipeline_in_memory(content).has_value();
+    }));
+    results.push_back(run_benchmark("stages/path/ConfigReadError", 0, [&] {
+        return call_pipeline(missing).has_value();
+    }));
+    results.push_back(run_benchmark("stages/path/ConfigParseError", malformed.size(), [&] {
+        return call_pipeline_in_memory(malformed).has_value();
+    }));
+    results.push_back(run_benchmark("stages/path/ValidationError", invalid.size(), [&] {
+        return call_pipeline_in_memory(invalid).has_value();
+    }));
+    results.push_back(run_benchmark("stages/path/ProcessingError", too_short.size(), [&] {
+        return call_pipeline_in_memory(too_short).has_value();
+    }));
+    return results;
+}
+
+// Branch-predictability benchmarks.
+// Each run feeds the pipeline a fixed stream of inputs in which a given
+// fraction fail with one PipelineError alternative. The pattern decides how
+// well the branch predictor can learn the and_then short-circuit:
+// Deterministic puts all failures in one run at the start of the stream,
+// Periodic spreads them evenly, and Random draws each one independently.
+enum class FailurePattern { Deterministic, Periodic, Random };
+
+inline constexpr std::string_view kFailurePatternNames[] = {"deterministic", "periodic", "random"};
+
+// Returns `length` flags, true where the input should fail.
+std::vector<std::uint8_t> make_failure_stream(FailurePattern pattern, double failure_rate, std::size_t length,
+                                              std::uint64_t seed = 0x9e3779b97f4a7c15) {
+    std::vector<std::uint8_t> stream(length, 0);
+    const auto failures = static_cast<std::size_t>(failure_rate * static_cast<double>(length) + 0.5);
+    switch (pattern) {
+        case FailurePattern::Deterministic:
+            std::fill_n(stream.begin(), std::min(failures, length), std::uint8_t{1});
+            break;
+        case FailurePattern::Periodic:
+            for (std::size_t i = 0; i < failures; ++i) {
+                stream[i * length / failures] = 1;
+            }
+            break;
+        case FailurePattern::Random:
+            for (auto& flag : stream) {
+                // xorshift64: reproducible across runs and platforms.
+                seed ^= seed << 13;
+                seed ^= seed >> 7;
+                seed ^= seed << 17;
+                flag = static_cast<double>(seed >> 11) * 0x1.0p-53 < failure_rate;
+            }
+            break;
+    }
+    return stream;
+}
+
+// Every in-memory PipelineError alternative against each pattern and failure
+// rate. ConfigReadError needs a file system miss and OutOfMemoryError cannot be
+// forced on demand, so both are left out.
+std::vector<BenchmarkResult> run_branch_benchmarks() {
+    struct Input {
+        std::string content;
+        RunLimit limit;
+    };
+    struct Failure {
+        std::string_view name;
+        Input input;
+    };
+    std::stop_source stopped;
+    stopped.request_stop();
+    const RunLimit expired(std::stop_token{}, RunLimit::Clock::time_point{}, PipelineBudget{.total = std::chrono::nanoseconds::zero()},
+                           PipelineBudget::kUnlimited);
+    const Input ok{"valid_data_content", {}};
+    const Failure failures[] = {
+        {"ConfigParseError", {"valid_data_content malformed", {}}},
+        {"ValidationError", {"valid_data_content invalid_field", {}}},
+        {"ProcessingError", {"short", {}}},
+        {"Cancelled", {"valid_data_content", stopped.get_token()}},
+        {"DeadlineExceeded", {"valid_data_content", expired}},
+    };
+    constexpr double kFailureRates[] = {0.01, 0.1, 0.5};
+    constexpr std::size_t kStreamLength = std::size_t{1} << 16; // longer than any branch history
+
+    const auto run = [](const Input& input) {
+        return ParseConfig(input.content, "<memory>", input.limit)
+            .and_then([&](const Config& cfg) { return ValidateData(cfg, input.limit); })
+            .and_then([](const ValidatedData& vd) { return ProcessData(vd); });
+    };
+    std::vector<BenchmarkResult> results;
+    results.push_back(run_benchmark("branches/none", 0, [&] { return run(ok).has_value(); }));
+    for (const auto& failure : failures) {
+        for (std::size_t p = 0; p < std::size(kFailurePatternNames); ++p) {
+            for (const double rate : kFailureRates) {
+                const auto stream = make_failure_stream(static_cast<FailurePattern>(p), rate, kStreamLength);
+                const Input* inputs[] = {&ok, &failure.input};
+                std::size_t next = 0;
+                std::string name = "branches/" + std::string(failure.name) + "/" + std::string(kFailurePatternNames[p]) +
+                                   "/" + std::to_string(static_cast<int>(rate * 100)) + "%";
+                results.push_back(run_benchmark(std::move(name), 0, [&] {
+                    const Input& input = *inputs[stream[next]];
+                    next = (next + 1) & (kStreamLength - 1);
+                    return run(input).has_value();
+                }));
+            }
+        }
+    }
+    return results;
+}
+
+struct BenchmarkSuite {
+    std::string_view name;
+    std::vector<BenchmarkResult> (*run)();
+};
+
+inline constexpr BenchmarkSuite kBenchmarkSuites[] = {
+    {"regex", run_regex_benchmarks},
+    {"errors", run_error_benchmarks},
+    {"stages", run_stage_benchmarks},
+    {"branches", run_branch_benchmarks},
+};
+
+// Runs the named suite, or all of them for an empty name.
+int run_benchmarks(std::string_view suite) {
+    g_debug_logging.store(false, std::memory_order_relaxed);
+    std::vector<BenchmarkResult> results;
+    bool found = false;
+    for (const auto& s : kBenchmarkSuites) {
+        if (suite.empty() || suite == s.name) {
+            found = true;
+            auto suite_results = s.run();
+            results.insert(results.end(), suite_results.begin(), suite_results.end());
+        }
+    }
+    if (!found) {
+        std::cerr << "Unknown benchmark suite '" << suite << "'" << std::endl;
+        return 1;
+    }
+    print_benchmarks_json(results, std::cout);
+    return 0;
+}
+
+void test_read_nonexisted_config_file() {
+    const std::string filename = "this_file_should_not_exist.txt";
+    ConfigReadError expected = {
+        .filename = filename,
+    };
+    auto ret = call_pipeline(filename);
+
+    assert(ret.has_value() == false);
+    auto target = ret.error();
+    ConfigReadError *c = std::get_if<ConfigReadError>(&target);
+    assert(c != nullptr);
+    assert(c->filename == expected.filename);
+
+    std::cout << "test_read_nonexisted_config_file() passes" << std::endl;
+}
+
+void test_stack_capture_sampling() {
+    set_stack_sample_period(0);
+    ProcessingError unsampled{"task", "details"};
+    assert(unsampled.stack.id == 0);
+
+#if defined(PIPELINE_ENABLE_STACKTRACE)
+    set_stack_sample_period(1);
+    ProcessingError sampled{"task", "details"};
+    ProcessingError copy = sampled;
+    assert(sampled.stack.id != 0);
+    assert(copy.stack.id == sampled.stack.id);
+    set_stack_sample_period(0);
+#endif
+
+    std::cout << "test_stack_capture_sampling() passes" << std::endl;
+}
+
+void test_error_reporter_aggregates_storm() {
+    std::ostringstream out;
+    const auto t0 = ErrorReporter::Clock::time_point{};
+    {
+        ErrorReporter reporter(out, {.window = std::chrono::seconds(1), .max_exemplars = 2});
+        for (int i = 0; i < 12345; ++i) {
+            reporter.report(ValidationError{"invalid_field", "contains disallowed value"}, t0);
+        }
+        reporter.report(ProcessingError{"Data Processing", "Input data too short for task"}, t0);
+        // Crossing the window boundary flushes the first window.
+        reporter.report(ConfigReadError{"missing.txt"}, t0 + std::chrono::seconds(2));
+    }
+    const std::string text = out.str();
+
+    std::size_t exemplars = 0;
+    for (auto pos = text.find("Pipeline Failed!"); pos != std::string::npos;
+         pos = text.find("Pipeline Failed!", pos + 1)) {
+        ++exemplars;
+    }
+    assert(exemplars == 3); // two in the first window, one in the second
+    assert(text.find("ValidationError invalid_field x 12,345") != std::string::npos);
+    assert(text.find("ProcessingError Data Processing x 1") != std::string::npos);
+    assert(text.find("ConfigReadError x 1") != std::string::npos);
+    assert(text.find("ConfigReadError x 1") > text.find("ValidationError invalid_field x 12,345"));
+
+    // An expired window is summarized by tick() without waiting for another error.
+    std::ostringstream ticked;
+    ErrorReporter reporter(ticked, {.window = std::chrono::seconds(1), .max_exemplars = 0});
+    reporter.report(ValidationError{"invalid_field", "contains disallowed value"}, t0);
+    reporter.tick(t0 + std::chrono::milliseconds(500));
+    assert(ticked.str().empty());
+    reporter.tick(t0 + std::chrono::seconds(1));
+    assert(ticked.str() == "Error summary:\n  ValidationError invalid_field x 1\n");
+    reporter.tick(t0 + std::chrono::seconds(5));
+    assert(ticked.str() == "Error summary:\n  ValidationError invalid_field x 1\n");
+
+    std::cout << "test_error_reporter_aggregates_storm() passes" << std::endl;
+}
+
+void test_pipelined_matches_sequential() {
+    std::ofstream("pipelined_valid.txt") << "valid_data_content";
+    std::ofstream("pipelined_malformed.txt") << "malformed content";
+    std::ofstream("pipelined_invalid.txt") << "valid_data\ninvalid_field";
+    std::ofstream("pipelined_short.txt") << "short";
+    const std::vector<std::string> base = {
+        "pipelined_valid.txt", "pipelined_missing.txt", "pipelined_malformed.txt",
+        "pipelined_invalid.txt", "pipelined_short.txt",
+    };
+    // More files than queue slots, so backpressure is exercised.
+    std::vector<std::string> files;
+    for (int i = 0; i < 20; ++i) {
+        files.insert(files.end(), base.begin(), base.end());
+    }
+
+    auto results = call_pipeline_pipelined(files, 4);
+    assert(results.size() == files.size());
+    for (std::size_t i = 0; i < files.size(); ++i) {
+        auto expected = call_pipeline(files[i]);
+        assert(results[i].has_value() == expected.has_value());
+        if (expected) {
+            assert(results[i]->final_result_code == expected->final_result_code);
+        } else {
+            assert(results[i].error().index() == expected.error().index());
+        }
+    }
+
+    for (const auto& file : base) {
+        std::remove(file.c_str());
+    }
+
+    // Opening a FIFO blocks the loader until a writer shows up. Meanwhile the
+    // other stages and the sink must sleep rather than spin: every thread but
+    // this one reaches state 'S' in /proc. A spinning thread stays runnable.
+    const auto others_sleeping = [] {
+        const std::string self = std::to_string(::gettid());
+        for (const auto& task : std::filesystem::directory_iterator("/proc/self/task")) {
+            if (task.path().filename() == self) {
+                continue;
+            }
+            std::string stat;
+            std::getline(std::ifstream(task.path() / "stat"), stat);
+            const auto name_end = stat.rfind(')');
+            if (name_end == std::string::npos || name_end + 2 >= stat.size() || stat[name_end + 2] != 'S') {
+                return false;
+            }
+        }
+        return true;
+    };
+    const char* fifo = "pipelined_fifo.txt";
+    std::remove(fifo);
+    const int made = ::mkfifo(fifo, 0600);
+    assert(made == 0);
+    std::vector<std::expected<Result, PipelineError>> blocked;
+    std::jthread run([&] { blocked = call_pipeline_pipelined({fifo}); });
+    bool idle = false;
+    for (int attempt = 0; attempt < 1000 && !idle; ++attempt) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        idle = others_sleeping();
+    }
+    std::ofstream(fifo) << "valid_data_content";
+    run.join();
+    assert(blocked.size() == 1 && blocked[0].has_value());
+    assert(idle);
+    std::remove(fifo);
+    std::cout << "test_pipelined_matches_sequential() passes" << std::endl;
+}
+
+void test_config_image_roundtrip_and_fallback() {
+    const std::string image_path = "configs.img";
+    std::ofstream("image_valid.txt") << "valid_data_content";
+    std::ofstream("image_other.txt") << "another_valid_config";
+
+    std::ofstream("image_alpha.txt") << "first_valid_config";
+    std::ofstream("image_zeta.txt") << "last_valid_config";
+
+    // Listed out of order; the image sorts them for the binary search.
+    auto compiled = CompileConfigImage({"image_zeta.txt", "image_valid.txt", "image_alpha.txt", "image_other.txt"},
+                                       image_path);
+    assert(compiled.has_value());
+    auto image = ConfigImage::Open(image_path);
+    assert(image.has_value());
+    assert(image->size() == 4);
+    assert(image->Lookup("image_alpha.txt")->processed_data == "Validated: first_valid_config");
+    assert(image->Lookup("image_zeta.txt")->processed_data == "Validated: last_valid_config");
+    for (const char* absent : {"image_", "image_b.txt", "image_zz.txt", "a.txt"}) {
+        auto miss = image->Lookup(absent);
+        assert(!miss.has_value() && std::holds_alternative<ConfigReadError>(miss.error()));
+    }
+
+    auto hit = image->Lookup("image_valid.txt");
+    assert(hit.has_value());
+    assert(hit->processed_data == "Validated: valid_data_content");
+    assert(call_pipeline("image_valid.txt", *image)->final_result_code ==
+           call_pipeline("image_valid.txt")->final_result_code);
+
+    // A changed source makes the entry stale; call_pipeline falls back to the text path.
+    std::ofstream("image_other.txt") << "now with invalid_field";
+    auto stale = image->Lookup("image_other.txt");
+    assert(!stale.has_value() && std::holds_alternative<ConfigReadError>(stale.error()));
+    auto fallback = call_pipeline("image_other.txt", *image);
+    assert(!fallback.has_value() && std::holds_alternative<ValidationError>(fallback.error()));
+
+    // A flipped byte is caught by the checksum.
+    {
+        std::fstream f(image_path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(-1, std::ios::end);
+        f.put('#');
+    }
+    auto corrupt = ConfigImage::Open(image_path);
+    assert(!corrupt.has_value() && std::holds_alternative<ConfigParseError>(corrupt.error()));
+
+    // An offset near 2^64 must not wrap the bounds check, even with a valid checksum.
+    assert(CompileConfigImage({"image_valid.txt"}, image_path).has_value());
+    std::ostringstream raw;
+    raw << std::ifstream(image_path, std::ios::binary).rdbuf();
+    std::string bytes = std::move(raw).str();
+    ImageEntry entry;
+    std::memcpy(&entry, bytes.data() + sizeof(ImageHeader), sizeof(entry));
+    entry.data_offset = UINT64_MAX - 2;
+    std::memcpy(bytes.data() + sizeof(ImageHeader), &entry, sizeof(entry));
+    ImageHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    header.checksum = fnv1a64(std::string_view(bytes).substr(sizeof(ImageHeader)));
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    std::ofstream(image_path, std::ios::binary | std::ios::trunc) << bytes;
+    auto wrapped = ConfigImage::Open(image_path);
+    assert(!wrapped.has_value() && std::holds_alternative<ConfigParseError>(wrapped.error()));
+
+    std::remove(image_path.c_str());
+    std::remove("image_valid.txt");
+    std::remove("image_other.txt");
+    std::remove("image_alpha.txt");
+    std::remove("image_zeta.txt");
+    std::cout << "test_config_image_roundtrip_and_fallback() passes" << std::endl;
+}
+
+// Runs the ValidateData scan itself: the default rules over text above
+// kParallelScanThreshold, with several thread counts.
+void test_parallel_scan_matches_sequential() {
+    const PatternRuleEngine& engine = default_rule_engine();
+    const std::string_view token = kForbiddenField;
+    std::string clean;
+    for (int line = 0; line < 40000; ++line) {
+        clean += "key_" + std::to_string(line) + " = some_reasonably_long_value\n";
+    }
+    assert(clean.size() >= kParallelScanThreshold);
+    const auto offset_of = [&engine](std::string_view text, unsigned threads) {
+        const auto match = engine.find_first(text, threads);
+        return match ? match->offset : std::string_view::npos;
+    };
+
+    std::string data = clean;
+    data.insert(data.size() / 3, "first invalid_field\n");
+    data.insert(data.size() * 2 / 3, "second invalid_field\n");
+    for (unsigned threads : {1u, 2u, 3u, 7u, 16u}) {
+        assert(offset_of(data, threads) == data.find(token));
+        assert(offset_of(clean, threads) == std::string_view::npos);
+
+        // A match across the even split point of the first chunk: the cut
+        // moves to the next newline, so the match stays whole.
+        if (threads > 1) {
+            std::string straddling = clean;
+            const std::size_t split = (clean.size() + token.size()) / threads;
+            straddling.insert(split - token.size() / 2, token);
+            assert(offset_of(straddling, threads) == split - token.size() / 2);
+        }
+    }
+    // A token at the very start and at the very end of the buffer.
+    const std::string edges = std::string(token) + "\n" + clean + std::string(token);
+    assert(offset_of(edges, 8) == 0);
+    assert(offset_of(clean + std::string(token), 8) == clean.size());
+
+    std::cout << "test_parallel_scan_matches_sequential() passes" << std::endl;
+}
+
+void test_batch_error_deduplication() {
+    std::ofstream("batch_valid.txt") << "valid_data_content";
+    std::ofstream("batch_invalid_a.txt") << "a\ninvalid_field";
+    std::ofstream("batch_invalid_b.txt") << "b\ninvalid_field";
+    std::vector<std::string> files = {"batch_valid.txt", "batch_invalid_a.txt", "batch_invalid_b.txt"};
+    for (int i = 0; i < 50; ++i) {
+        files.push_back("batch_missing_" + std::to_string(i) + ".txt");
+    }
+
+    auto summary = call_pipeline_batch(files);
+    assert(summary.succeeded == 1);
+    assert(summary.groups.size() == 2);
+    assert(std::holds_alternative<ValidationError>(summary.groups[0].error));
+    assert(summary.groups[0].count == 2);
+    assert((summary.groups[0].files == std::vector<std::uint32_t>{1, 2}));
+    assert(std::holds_alternative<ConfigReadError>(summary.groups[1].error));
+    assert(summary.groups[1].count == 50);
+    assert(summary.groups[1].files.front() == 3 && summary.groups[1].files.back() == 52);
+
+    std::ostringstream out;
+    print_batch_summary(summary, files, out, 2);
+    assert(out.str().find("50 x Configuration Read Error") != std::string::npos);
+    assert(out.str().find("(and 48 more)") != std::string::npos);
+
+    std::remove("batch_valid.txt");
+    std::remove("batch_invalid_a.txt");
+    std::remove("batch_invalid_b.txt");
+    std::cout << "test_batch_error_deduplication() passes" << std::endl;
+}
+
+std::string read_whole_file(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+}
+
+void test_result_renderer_formats() {
+    const std::vector<std::expected<Result, PipelineError>> results = {
+        Result{28},
+        std::unexpected(ValidationError{"invalid_field", "say \"hi\"\n"}),
+        std::unexpected(ConfigParseError{"malformed", 1}),
+    };
+    const auto render_all = [&results](RenderFormat format, int repeat) {
+        const char* path = "renderer_output.bin";
+        const int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        assert(fd >= 0);
+        {
+            // A tiny threshold forces several flushes along the way.
+            ResultRenderer renderer(fd, format, 4096);
+            for (int i = 0; i < repeat; ++i) {
+                for (const auto& r : results) {
+                    renderer.render(r);
+                }
+            }
+        }
+        ::close(fd);
+        std::string text = read_whole_file(path);
+        std::remove(path);
+        return text;
+    };
+
+    const std::string text = render_all(RenderFormat::Text, 1);
+    assert(text == "Pipeline Succeeded! Final Result Code: 28\n"
+                   "Pipeline Failed! Error details: Data Validation Error: Field 'invalid_field' has invalid value 'say \"hi\"\n'\n"
+                   "Pipeline Failed! Error details: Configuration Parse Error: Malformed content at line 1 (Context: 'malformed')\n");
+
+    const std::string json = render_all(RenderFormat::JsonLines, 1);
+    assert(json == "{\"ok\":true,\"final_result_code\":28}\n"
+                   "{\"ok\":false,\"error\":\"ValidationError\",\"field_name\":\"invalid_field\",\"invalid_value\":\"say \\\"hi\\\"\\u000a\"}\n"
+                   "{\"ok\":false,\"error\":\"ConfigParseError\",\"line_content\":\"malformed\",\"line_number\":1}\n");
+
+    const std::string binary = render_all(RenderFormat::Binary, 1);
+    assert(binary.size() == (1 + 4) + (1 + 4 + 13 + 4 + 9 + 8) + (1 + 4 + 9 + 4));
+    assert(binary[0] == 0 && binary[5] == 3);
+
+    // Many results spanning several chunks and flushes stay intact and ordered.
+    const std::string many = render_all(RenderFormat::Text, 5000);
+    std::string expected_many;
+    for (int i = 0; i < 5000; ++i) {
+        expected_many += text;
+    }
+    assert(many == expected_many);
+
+    std::cout << "test_result_renderer_formats() passes" << std::endl;
+}
+
+void test_in_memory_pipeline_and_fuzz_limits() {
+    const std::vector<std::string> seeds = {
+        "valid_data_content", "malformed content", "valid_data\ninvalid_field", "short", "",
+    };
+    for (const auto& seed : seeds) {
+        std::ofstream("fuzz_seed.txt") << seed;
+        auto from_file = call_pipeline("fuzz_seed.txt");
+        FuzzReport report = run_fuzz_input(seed);
+        assert(report.result.has_value() == from_file.has_value());
+        if (!from_file) {
+            assert(report.result.error().index() == from_file.error().index());
+        }
+        assert(!report.too_slow && !report.too_much_memory);
+    }
+    std::remove("fuzz_seed.txt");
+
+    // With a zero budget every input is flagged as slow.
+    FuzzLimits strict{.max_ns_per_byte = 0.0, .time_slack = std::chrono::nanoseconds(-1)};
+    assert(run_fuzz_input("valid_data_content", strict).too_slow);
+
+    std::cout << "test_in_memory_pipeline_and_fuzz_limits() passes" << std::endl;
+}
+
+// Fuzz builds provide LLVMFuzzerTestOneInput instead of main.
+#if !defined(PIPELINE_FUZZ)
+// Per-scenario heap allocation budgets for the pipeline. Lower a budget when
+// a change saves allocations; a change that needs more must raise it here.
+void test_pipeline_allocation_budgets() {
+    struct Scenario {
+        const char* filename;
+        const char* content; // nullptr: the file does not exist
+        std::size_t index;   // variant index of the expected error, npos for success
+        std::uint64_t budget;
+    };
+    // The file stream's buffer accounts for one allocation whenever the file
+    // opens, and the content copy for another; errors themselves allocate nothing.
+    const Scenario scenarios[] = {
+        {"budget_valid.txt", "valid_data_content", std::variant_npos, 3},
+        {"budget_missing.txt", nullptr, 0, 0},
+        {"budget_malformed.txt", "malformed content", 1, 2},
+        {"budget_invalid.txt", "valid_data\ninvalid_field", 2, 2},
+    };
+
+    g_debug_logging.store(false, std::memory_order_relaxed);
+    for (const auto& scenario : scenarios) {
+        if (scenario.content != nullptr) {
+            std::ofstream(scenario.filename) << scenario.content;
+        }
+        const std::string filename = scenario.filename;
+        const AllocationScope scope;
+        auto result = call_pipeline(filename);
+        const AllocationStats stats = scope.stats();
+
+        assert(result.has_value() == (scenario.index == std::variant_npos));
+        assert(result.has_value() || result.error().index() == scenario.index);
+        assert(stats.count <= scenario.budget);
+        std::remove(scenario.filename);
+    }
+
+    // The "Validated: " prefix keeps file inputs long enough, so the
+    // ProcessingError path is measured on ProcessData directly.
+    const ValidatedData too_short{"short"};
+    const AllocationScope scope;
+    auto processed = ProcessData(too_short);
+    assert(!processed.has_value() && std::holds_alternative<ProcessingError>(processed.error()));
+    assert(scope.stats().count == 0);
+
+    // Regex-rule failures copy their text into the error inline. The text is
+    // longer than std::string's small-buffer capacity.
+    using Rules = RegexRuleSet<RegexRule<"password\\s*=", "plain_text_password", "password stored in the config">>;
+    const Config leaked{"user = me\npassword = x"};
+    {
+        const AllocationScope rule_scope;
+        auto rejected = ValidateData(leaked, Rules{});
+        assert(!rejected.has_value() && std::holds_alternative<ValidationError>(rejected.error()));
+        assert(rule_scope.stats().count == 0);
+    }
+    g_debug_logging.store(true, std::memory_order_relaxed);
+
+    std::cout << "test_pipeline_allocation_budgets() passes" << std::endl;
+}
+
+#if defined(PIPELINE_TESTING)
+void test_allocation_failure_is_reported() {
+    g_debug_logging.store(false, std::memory_order_relaxed);
+    // Fail the 2nd allocation: the copy of the content succeeds, building the
+    // validated payload does not.
+    t_fail_allocation_number = t_allocation_stats.count + 2;
+    auto result = call_pipeline_in_memory("valid_data_content that is long enough");
+    t_fail_allocation_number = 0;
+    g_debug_logging.store(true, std::memory_order_relaxed);
+
+    assert(!result.has_value());
+    const auto* oom = std::get_if<OutOfMemoryError>(&result.error());
+    assert(oom != nullptr);
+    assert(oom->stage == "call_pipeline_in_memory");
+    assert(oom->requested_bytes > 0);
+
+    // The pipeline works again once memory is available.
+    assert(call_pipeline_in_memory("valid_data_content").has_value());
+
+    // A failed request larger than the emergency reserve. With exceptions it
+    // is an OutOfMemoryError like any other; without, the process aborts with
+    // a message, so it runs in a child.
+    const std::size_t huge = EmergencyReserve::kSize * 4;
+#if defined(__cpp_exceptions)
+    t_fail_allocation_number = t_allocation_stats.count + 1;
+    auto too_big = guard_allocations("huge", [huge]() -> std::expected<Result, PipelineError> {
+        const std::string text(huge, 'x');
+        return Result{static_cast<int>(text.size())};
+    });
+    t_fail_allocation_number = 0;
+    assert(!too_big.has_value());
+    assert(std::get<OutOfMemoryError>(too_big.error()).requested_bytes > huge);
+#else
+    int err_pipe[2];
+    const int piped = ::pipe(err_pipe);
+    assert(piped == 0);
+    const pid_t child = ::fork();
+    assert(child >= 0);
+    if (child == 0) {
+        ::dup2(err_pipe[1], STDERR_FILENO);
+        t_fail_allocation_number = t_allocation_stats.count + 1;
+        const std::string text(huge, 'x');
+        ::_exit(text.empty() ? 1 : 0);
+    }
+    ::close(err_pipe[1]);
+    char message[256] = {};
+    const ssize_t got = ::read(err_pipe[0], message, sizeof(message) - 1);
+    ::close(err_pipe[0]);
+    int status = 0;
+    const pid_t reaped = ::waitpid(child, &status, 0);
+    assert(reaped == child);
+    assert(WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT);
+    assert(got > 0 && std::string_view(message).find("exceeds the emergency reserve") != std::string_view::npos);
+#endif
+    std::cout << "test_allocation_failure_is_reported() passes" << std::endl;
+}
+#endif
+
+// Embedded configs are validated while compiling this file.
+inline constexpr Result kEmbeddedResult = validate_embedded_config<"valid_data_content">();
+static_assert(kEmbeddedResult.final_result_code == 29);
+static_assert(call_pipeline_constexpr("malformed content").error() == PipelineErrorKind::ConfigParse);
+static_assert(call_pipeline_constexpr("").error() == PipelineErrorKind::ConfigParse);
+static_assert(call_pipeline_constexpr("valid_data\ninvalid_field").error() == PipelineErrorKind::Validation);
+
+// The default rules as a compile-time regex set, checked against the table.
+using DefaultRegexRules = RegexRuleSet<RegexRule<"invalid_field", "invalid_field", "contains disallowed value">>;
+static_assert(std::size(kDefaultRules) == 1 && kDefaultRules[0].pattern == "invalid_field");
+
+void test_constexpr_stages_match_runtime() {
+    // One corpus for the constexpr stages, the automaton and the regex rules.
+    const std::vector<std::string> contents = {
+        "valid_data_content", "malformed content", "valid_data\ninvalid_field", "short", "",
+        "invalid_field", "prefix invalid_field", "invalid_field suffix", "invalid_fiel", "nvalid_field",
+        "invalid_invalid_field", "invalid_\nfield", "INVALID_FIELD content", "a = 1\nb = 2\nc = invalid_field\n",
+        "malformed invalid_field", "0123456", std::string(5000, 'x') + "invalid_field",
+    };
+    g_debug_logging.store(false, std::memory_order_relaxed);
+    for (const auto& content : contents) {
+        auto runtime = call_pipeline_in_memory(content);
+        auto compile_time = call_pipeline_constexpr(content);
+        assert(runtime.has_value() == compile_time.has_value());
+        if (runtime) {
+            assert(runtime->final_result_code == compile_time->final_result_code);
+        } else {
+            assert(runtime.error().index() == static_cast<std::size_t>(compile_time.error()));
+        }
+
+        const Config config{content};
+        const auto automaton = ValidateData(config);
+        const auto regex = ValidateData(config, DefaultRegexRules{});
+        const bool constexpr_accepts = ValidateDataConstexpr(content).has_value();
+        assert(automaton.has_value() == constexpr_accepts && regex.has_value() == constexpr_accepts);
+        if (!constexpr_accepts) {
+            const auto& from_automaton = std::get<ValidationError>(automaton.error());
+            const auto& from_regex = std::get<ValidationError>(regex.error());
+            assert(from_automaton.field_name == from_regex.field_name);
+            assert(from_automaton.invalid_value == from_regex.invalid_value);
+        }
+    }
+    g_debug_logging.store(true, std::memory_order_relaxed);
+    std::cout << "test_constexpr_stages_match_runtime() passes" << std::endl;
+}
+
+#if defined(PIPELINE_EMBED_CONFIG) || defined(PIPELINE_EMBED_CONFIG_BYTES)
+void test_embedded_config_matches_text_path() {
+    g_debug_logging.store(false, std::memory_order_relaxed);
+    auto config = LoadEmbeddedConfig();
+    assert(config.has_value());
+    assert(config->data == embedded_config_view());
+    auto runtime = call_pipeline_in_memory(embedded_config_view());
+    assert(runtime.has_value());
+    assert(call_pipeline_embedded()->final_result_code == runtime->final_result_code);
+    g_debug_logging.store(true, std::memory_order_relaxed);
+    std::cout << "test_embedded_config_matches_text_path() passes" << std::endl;
+}
+#endif
+
+void test_pattern_rule_engine() {
+    const auto engine = PatternRuleEngine::compile({
+        {"he", "greeting", "short he"},
+        {"she", "pronoun", "she"},
+        {"his", "pronoun", "his"},
+        {"hers", "pronoun", "hers"},
+        {"", "ignored", "empty patterns never match"},
+    });
+
+    // Every occurrence agrees with a brute-force search.
+    const std::string text = "ushers and his sheep; she said hers\nhe";
+    std::vector<std::pair<std::uint32_t, std::size_t>> found;
+    engine.for_each_match(text, [&found](PatternRuleEngine::Match m) { found.emplace_back(m.rule, m.offset); });
+    std::vector<std::pair<std::uint32_t, std::size_t>> expected;
+    for (std::uint32_t r = 0; r < 4; ++r) {
+        const std::string& pattern = engine.rule(r).pattern;
+        for (auto pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
+            expected.emplace_back(r, pos);
+        }
+    }
+    std::sort(found.begin(), found.end());
+    std::sort(expected.begin(), expected.end());
+    assert(found == expected);
+
+    // "ushers": "she" ends first, before "he" and "hers".
+    auto first = engine.find_first(text);
+    assert(first.has_value() && engine.rule(first->rule).pattern == "she" && first->offset == 1);
+    assert(!engine.find_first("nothing to see").has_value());
+
+    // ValidateData reports the rule's field and the match offset.
+    auto result = ValidateData(Config{"key = value\nhis value"}, engine);
+    assert(!result.has_value());
+    const auto& error = std::get<ValidationError>(result.error());
+    assert(error.field_name == "pronoun" && error.invalid_value == "his" && error.offset == 12);
+
+    // The chunked parallel scan returns the same first match as one pass.
+    std::string big;
+    for (int line = 0; line < 40000; ++line) {
+        big += "key_" + std::to_string(line) + " = some_reasonably_long_value\n";
+    }
+    assert(big.size() >= kParallelScanThreshold);
+    const std::size_t line_start = big.find('\n', big.size() / 2) + 1;
+    big.insert(line_start, "x = hers\n");
+    for (unsigned threads : {1u, 3u, 16u}) {
+        auto hit = engine.find_first(big, threads);
+        assert(hit.has_value() && hit->offset == line_start + 4);
+    }
+
+    std::cout << "test_pattern_rule_engine() passes" << std::endl;
+}
+
+void test_compile_time_regex_rules() {
+    // Each pattern is checked against std::regex on the same inputs.
+    const std::vector<std::string> inputs = {
+        "", "abc", "password = hunter2", "key=value\nsecret_123\n", "aaab", "ab", "xyz\nend",
+        "port: 8080", "port: http", "[x]", "a.b", "tab\there",
+    };
+    const auto agree = [&inputs](auto search, const char* pattern) {
+        const std::regex re(pattern, std::regex::ECMAScript | std::regex::multiline);
+        for (const auto& input : inputs) {
+            std::smatch m;
+            const bool found = std::regex_search(input, m, re);
+            const std::size_t expected = found ? static_cast<std::size_t>(m.position(0)) : std::string::npos;
+            assert(search(input) == expected);
+        }
+    };
+    agree(CompiledRegex<"secret_[0-9]+">::search, "secret_[0-9]+");
+    agree(CompiledRegex<"password\\s*=\\s*\\w+">::search, "password\\s*=\\s*\\w+");
+    agree(CompiledRegex<"a*b">::search, "a*b");
+    agree(CompiledRegex<"(ab|b)+$">::search, "(ab|b)+$");
+    agree(CompiledRegex<"^end">::search, "^end");
+    agree(CompiledRegex<"port: [^0-9]">::search, "port: [^0-9]");
+    agree(CompiledRegex<"\\[x\\]|a\\.b">::search, "\\[x\\]|a\\.b");
+    agree(CompiledRegex<"t(a|e)?b\\s">::search, "t(a|e)?b\\s");
+
+    using Rules = RegexRuleSet<
+        RegexRule<"secret_[0-9]+", "secret", "plain-text secret">,
+        RegexRule<"password\\s*=", "password", "inline password">>;
+    auto result = ValidateData(Config{"user = me\npassword = x\nsecret_42"}, Rules{});
+    assert(!result.has_value());
+    const auto& error = std::get<ValidationError>(result.error());
+    assert(error.field_name == "password" && error.invalid_value == "inline password" && error.offset == 10);
+    assert(ValidateData(Config{"user = me"}, Rules{}).has_value());
+
+    // Matching allocates nothing.
+    const std::string text(4096, 'x');
+    const AllocationScope scope;
+    assert(Rules::check(text) == std::nullopt);
+    assert(scope.stats().count == 0);
+
+    std::cout << "test_compile_time_regex_rules() passes" << std::endl;
+}
+
+struct ServiceSettings {
+    std::int64_t port = 0;
+    bool enabled = false;
+    double ratio = 0.0;
+    std::string name;
+};
+
+using ServiceSchema = ConfigSchema<ServiceSettings,
+    SchemaField<"port", &ServiceSettings::port>,
+    SchemaField<"enabled", &ServiceSettings::enabled>,
+    SchemaField<"ratio", &ServiceSettings::ratio>,
+    SchemaField<"name", &ServiceSettings::name>>;
+
+static_assert(ServiceSchema::find("port") == 0 && ServiceSchema::find("name") == 3);
+static_assert(ServiceSchema::find("nme") == -1 && ServiceSchema::find("") == -1);
+
+void test_schema_extraction() {
+    auto settings = ExtractConfig(Config{"# service\nport = 8080\nenabled=true\n\nratio = 0.25\nname = api gateway\n"},
+                                  ServiceSchema{});
+    assert(settings.has_value());
+    assert(settings->port == 8080 && settings->enabled && settings->ratio == 0.25 && settings->name == "api gateway");
+
+    const auto error_of = [](const char* text) {
+        auto result = ExtractConfig(Config{text}, ServiceSchema{});
+        assert(!result.has_value());
+        return std::get<ValidationError>(result.error());
+    };
+    auto mismatch = error_of("port = eighty\nenabled = true\nratio = 1\nname = x");
+    assert(mismatch.field_name == "port" && mismatch.invalid_value == "eighty" && mismatch.offset == 0);
+    auto unknown = error_of("port = 1\nhost = example\n");
+    assert(unknown.field_name == "host" && unknown.invalid_value == "unknown key" && unknown.offset == 9);
+    auto missing = error_of("port = 1\nenabled = false\nname = x");
+    assert(missing.field_name == "ratio" && missing.invalid_value == "missing key");
+    auto duplicate = error_of("port = 1\nport = 2");
+    assert(duplicate.field_name == "port" && duplicate.invalid_value == "duplicate key");
+    auto no_equals = error_of("port 1");
+    assert(no_equals.field_name == "port 1");
+
+    assert(ValidateData(Config{"port = 1\nenabled = true\nratio = 2\nname = n"}, ServiceSchema{}).has_value());
+
+    // Schema failures copy their text into the error inline, without
+    // allocating, even past std::string's small-buffer capacity.
+    const Config bad_schema[] = {
+        Config{"a line without any equals sign"},               // no '='
+        Config{"port = 1\nan_unexpected_key_name = example"},   // unknown key
+        Config{"port = 1\nport = 2"},                           // duplicate key
+        Config{"port = eighty thousand and one"},               // type mismatch
+        Config{"port = 1\nenabled = true\nratio = 1"},          // missing key
+    };
+    const AllocationScope scope;
+    for (const Config& config : bad_schema) {
+        auto extracted = ExtractConfig(config, ServiceSchema{});
+        assert(!extracted.has_value() && std::holds_alternative<ValidationError>(extracted.error()));
+    }
+    assert(scope.stats().count == 0);
+    std::cout << "test_schema_extraction() passes" << std::endl;
+}
+
+void test_inline_error_strings() {
+    static_assert(sizeof(ErrorName) == 64 && sizeof(ErrorText) == 128 && sizeof(ErrorPath) == 256);
+    static_assert(std::is_trivially_copyable_v<ValidationError>);
+
+    constexpr ErrorName fits("invalid_field");
+    static_assert(fits == "invalid_field" && !fits.truncated());
+
+    const std::string long_value(300, 'x');
+    const AllocationScope scope;
+    ValidationError error{"field", long_value, 7};
+    ProcessingError processing{"ProcessData", "Processed data too short."};
+    assert(scope.stats().count == 0);
+    assert(error.invalid_value.size() == ErrorText::capacity() && error.invalid_value.truncated());
+    assert(error.invalid_value == std::string_view(long_value).substr(0, ErrorText::capacity()));
+    assert(processing.task_name == "ProcessData" && !processing.details.truncated());
+
+    std::string text;
+    append_error_text(text, error);
+    assert(text == "Data Validation Error: Field 'field' has invalid value '" + std::string(ErrorText::capacity(), 'x') +
+                       "...' at offset 7");
+    std::cout << "test_inline_error_strings() passes" << std::endl;
+}
+
+void test_error_context_chain() {
+    const std::string filename = "context_invalid.txt";
+    std::ofstream(filename) << "valid_data\ninvalid_field";
+    g_debug_logging.store(false, std::memory_order_relaxed);
+    auto result = call_pipeline(filename);
+    assert(!result.has_value());
+
+    std::ostringstream out;
+    print_pipeline_error(result.error(), out);
+    const std::string text = out.str();
+    const auto stage = text.find("  in ValidateData ('context_invalid.txt') at ");
+    const auto caller = text.find("  in call_pipeline ('context_invalid.txt') at ");
+    assert(stage != std::string::npos && caller != std::string::npos && stage < caller);
+    assert(text.find("test_error_context_chain", caller) != std::string::npos);
+    assert(text.find("LoadConfig") == std::string::npos);
+
+    // The next run on this thread reuses the arena; the old chain is no longer printed.
+    auto missing = call_pipeline("context_missing.txt");
+    assert(!missing.has_value());
+    std::ostringstream stale;
+    print_pipeline_error(result.error(), stale);
+    assert(stale.str().find("  in ") == std::string::npos);
+    g_debug_logging.store(true, std::memory_order_relaxed);
+    std::remove(filename.c_str());
+
+    std::cout << "test_error_context_chain() passes" << std::endl;
+}
+
+void test_cancellation() {
+    g_debug_logging.store(false, std::memory_order_relaxed);
+    std::stop_source stopped;
+    stopped.request_stop();
+    const auto stage_of = [](const auto& result) {
+        assert(!result.has_value() && std::holds_alternative<Cancelled>(result.error()));
+        return std::get<Cancelled>(result.error()).stage;
+    };
+
+    const std::string filename = "cancel_config.txt";
+    std::ofstream(filename) << "valid_data_content";
+    assert(stage_of(call_pipeline(filename, stopped.get_token())) == "LoadConfig");
+    assert(call_pipeline(filename, std::stop_source().get_token()).has_value());
+    std::remove(filename.c_str());
+
+    assert(stage_of(ParseConfig("valid_data_content", "<memory>", stopped.get_token())) == "ParseConfig");
+    const Config big{std::string(kParallelScanThreshold * 16, 'x')};
+    assert(stage_of(ValidateData(big, stopped.get_token())) == "ValidateData");
+
+    // A stop requested mid-scan ends the run promptly.
+    std::stop_source source;
+    std::atomic<std::chrono::steady_clock::rep> requested_at{0};
+    std::jthread stopper([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        requested_at = std::chrono::steady_clock::now().time_since_epoch().count();
+        source.request_stop();
+    });
+    std::expected<ValidatedData, PipelineError> result;
+    do {
+        result = ValidateData(big, source.get_token());
+    } while (result.has_value());
+    const auto reaction = std::chrono::steady_clock::now().time_since_epoch() -
+                          std::chrono::steady_clock::duration(requested_at.load());
+    assert(stage_of(result) == "ValidateData");
+    assert(reaction < std::chrono::milliseconds(100));
+    g_debug_logging.store(true, std::memory_order_relaxed);
+
+    std::cout << "test_cancellation() passes" << std::endl;
+}
+
+void test_deadlines() {
+    using namespace std::chrono_literals;
+    g_debug_logging.store(false, std::memory_order_relaxed);
+    const auto deadline_of = [](const auto& result) {
+        assert(!result.has_value() && std::holds_alternative<DeadlineExceeded>(result.error()));
+        return std::get<DeadlineExceeded>(result.error());
+    };
+
+    const std::string filename = "deadline_config.txt";
+    std::ofstream(filename) << "valid_data_content";
+    assert(call_pipeline(filename, PipelineBudget{.total = 10s, .load = 5s, .validate = 5s, .process = 5s}).has_value());
+    const auto load = deadline_of(call_pipeline(filename, PipelineBudget{.load = 1ns}));
+    assert(load.stage == "LoadConfig" && load.budget == 1ns && !load.run_budget);
+    const auto process = deadline_of(call_pipeline(filename, PipelineBudget{.process = 1ns}));
+    assert(process.stage == "ProcessData");
+    const auto total = deadline_of(call_pipeline(filename, PipelineBudget{.total = 1ns, .validate = 10s}));
+    assert(total.stage == "LoadConfig" && total.run_budget);
+    std::remove(filename.c_str());
+
+    // A budget cuts a long scan short instead of being noticed at its end.
+    const Config big{std::string(kParallelScanThreshold * 64, 'x')};
+    const auto start = RunLimit::Clock::now();
+    const auto validate = deadline_of(ValidateData(big, RunLimit({}, start, PipelineBudget{}, 1ms)));
+    assert(validate.stage == "ValidateData" && validate.overrun < 50ms);
+    assert(RunLimit::Clock::now() - start < 51ms);
+
+    std::string text;
+    append_error_text(text, DeadlineExceeded{"ValidateData", 5ms, 1250us, false});
+    assert(text == "Deadline Exceeded: Stage 'ValidateData' ran 1.250 ms past its 5.000 ms budget");
+    g_debug_logging.store(true, std::memory_order_relaxed);
+
+    std::cout << "test_deadlines() passes" << std::endl;
+}
+
+void test_persistent_result_cache() {
+    const std::string cache_path = "result_cache.bin";
+    const std::vector<std::string> files = {"cache_valid.txt", "cache_invalid.txt", "cache_missing.txt"};
+    std::ofstream(files[0]) << "valid_data_content";
+    std::ofstream(files[1]) << "valid_data\ninvalid_field";
+    std::remove(cache_path.c_str());
+    g_debug_logging.store(false, std::memory_order_relaxed);
+
+    {
+        ResultCache cache(cache_path);
+        for (const auto& file : files) {
+            (void)call_pipeline(file, cache);
+        }
+        assert(cache.stats().hits == 0 && cache.stats().misses == 2);
+        const auto flushed = cache.Flush();
+        assert(flushed.has_value());
+    }
+    assert(!std::filesystem::exists(cache_path + ".tmp." + std::to_string(::getpid())));
+
+    // A restarted process gets the same outcomes without running the pipeline.
+    {
+        ResultCache cache(cache_path);
+        auto valid = call_pipeline(files[0], cache);
+        auto invalid = call_pipeline(files[1], cache);
+        auto missing = call_pipeline(files[2], cache);
+        assert(cache.stats().hits == 2 && cache.stats().hashed == 0);
+        assert(valid.has_value() && valid->final_result_code == call_pipeline(files[0])->final_result_code);
+        const auto& error = std::get<ValidationError>(invalid.error());
+        assert(error.field_name == "invalid_field" && error.offset == 11 && error.context.run == 0);
+        assert(!missing.has_value() && std::holds_alternative<ConfigReadError>(missing.error()));
+
+        // Touched but unchanged: one hash, still a hit. Edited: a miss.
+        std::filesystem::last_write_time(files[0], std::filesystem::last_write_time(files[0]) + std::chrono::seconds(5));
+        const auto touched = call_pipeline(files[0], cache);
+        assert(touched.has_value());
+        assert(cache.stats().hits == 3 && cache.stats().hashed == 1);
+        std::ofstream(files[1]) << "valid_data\nother_field__";
+        const auto edited = call_pipeline(files[1], cache);
+        assert(edited.has_value());
+        assert(cache.stats().hits == 3);
+        const auto flushed = cache.Flush();
+        assert(flushed.has_value());
+    }
+    {
+        ResultCache cache(cache_path);
+        const auto touched = call_pipeline(files[0], cache);
+        const auto edited = call_pipeline(files[1], cache);
+        assert(touched.has_value() && edited.has_value());
+        assert(cache.stats().hits == 2 && cache.stats().hashed == 0);
+    }
+
+    // A cache keeps serving, and keeps what it stored, across its own flushes.
+    {
+        std::remove(cache_path.c_str());
+        ResultCache cache(cache_path);
+        (void)call_pipeline(files[0], cache);
+        const auto first_flush = cache.Flush();
+        assert(first_flush.has_value());
+        const auto after_flush = call_pipeline(files[0], cache);
+        assert(after_flush.has_value());
+        assert(cache.stats().hits == 1);
+        (void)call_pipeline(files[1], cache);
+        const auto second_flush = cache.Flush();
+        assert(second_flush.has_value());
+    }
+    {
+        ResultCache cache(cache_path);
+        (void)call_pipeline(files[0], cache);
+        (void)call_pipeline(files[1], cache);
+        assert(cache.stats().hits == 2 && cache.stats().misses == 0);
+    }
+
+    // An offset near 2^64 must not wrap the bounds check, even with a valid
+    // checksum; the damaged cache is ignored.
+    {
+        std::ostringstream raw;
+        raw << std::ifstream(cache_path, std::ios::binary).rdbuf();
+        std::string bytes = std::move(raw).str();
+        CacheEntry entry;
+        std::memcpy(&entry, bytes.data() + sizeof(CacheHeader), sizeof(entry));
+        entry.result_offset = UINT64_MAX - 2;
+        std::memcpy(bytes.data() + sizeof(CacheHeader), &entry, sizeof(entry));
+        CacheHeader header;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        header.checksum = fnv1a64(std::string_view(bytes).substr(sizeof(CacheHeader)));
+        std::memcpy(bytes.data(), &header, sizeof(header));
+        std::ofstream(cache_path, std::ios::binary | std::ios::trunc) << bytes;
+
+        ResultCache cache(cache_path);
+        (void)call_pipeline(files[0], cache);
+        (void)call_pipeline(files[1], cache);
+        assert(cache.stats().hits == 0 && cache.stats().misses == 2);
+    }
+
+    // Every alternative survives the binary encoding.
+    using namespace std::chrono_literals;
+    const std::vector<std::expected<Result, PipelineError>> samples = {
+        Result{42},
+        std::unexpected(ConfigReadError{"a.txt"}),
+        std::unexpected(ConfigParseError{"malformed", 3}),
+        std::unexpected(ValidationError{"field", "value"}),
+        std::unexpected(ProcessingError{"ProcessData", "too short"}),
+        std::unexpected(OutOfMemoryError{"call_pipeline", 1 << 20}),
+        std::unexpected(Cancelled{"ValidateData"}),
+        std::unexpected(DeadlineExceeded{"LoadConfig", 5ms, 2us, true}),
+    };
+    std::string encoded;
+    for (const auto& sample : samples) {
+        ResultRenderer::append_binary(encoded, sample);
+    }
+    std::string_view in = encoded;
+    for (const auto& sample : samples) {
+        auto decoded = decode_binary_result(in);
+        assert(decoded && decoded->has_value() == sample.has_value());
+        assert(sample ? decoded->value().final_result_code == sample->final_result_code
+                      : same_error_cause(decoded->error(), sample.error()));
+    }
+    assert(in.empty() && !decode_binary_result(in));
+    std::string_view last = std::string_view(encoded).substr(encoded.size() - (1 + 4 + 10 + 8 + 8 + 1));
+    const auto deadline = std::get<DeadlineExceeded>(decode_binary_result(last)->error());
+    assert(deadline.stage == "LoadConfig" && deadline.budget == 5ms && deadline.overrun == 2us && deadline.run_budget);
+
+    // A damaged cache file is ignored.
+    {
+        std::fstream damage(cache_path, std::ios::in | std::ios::out | std::ios::binary);
+        damage.seekp(sizeof(CacheHeader) + 3);
+        damage.put('\x7f');
+    }
+    ResultCache damaged(cache_path);
+    const auto recomputed = call_pipeline(files[0], damaged);
+    assert(recomputed.has_value());
+    assert(damaged.stats().hits == 0 && damaged.stats().misses == 1);
+
+    g_debug_logging.store(true, std::memory_order_relaxed);
+    for (const auto& file : files) {
+        std::remove(file.c_str());
+    }
+    std::remove(cache_path.c_str());
+    std::cout << "test_persistent_result_cache() passes" << std::endl;
+}
+
+void test_validation_daemon() {
+    const std::string socket_path = "daemon_test.sock";
+    const std::string cache_path = "daemon_test.cache";
+    const std::string dir = std::filesystem::current_path().string() + "/";
+    const std::string valid = dir + "daemon_valid.txt";
+    const std::string invalid = dir + "daemon_invalid.txt";
+    std::ofstream(valid) << "valid_data_content";
+    std::ofstream(invalid) << "valid_data\ninvalid_field";
+    g_debug_logging.store(false, std::memory_order_relaxed);
+
+    // A path that is not a socket is never replaced.
+    std::remove(socket_path.c_str());
+    std::ofstream(socket_path) << "not a socket";
+    const auto over_file = ValidationDaemon::Listen(socket_path, cache_path);
+    assert(!over_file.has_value() && std::filesystem::is_regular_file(socket_path));
+    std::remove(socket_path.c_str());
+
+    // A socket left behind by a dead daemon is.
+    {
+        const sockaddr_un addr = unix_socket_address(socket_path);
+        const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        const int bound = ::bind(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr));
+        assert(fd >= 0 && bound == 0);
+        ::close(fd);
+    }
+    auto daemon = ValidationDaemon::Listen(socket_path, cache_path);
+    assert(daemon.has_value());
+    // A live daemon's socket is not taken over.
+    const auto second = ValidationDaemon::Listen(socket_path, cache_path + ".other");
+    assert(!second.has_value());
+    std::stop_source stop;
+    std::jthread server([&daemon, token = stop.get_token()] { daemon->Run(token); });
+
+    auto client = DaemonClient::Connect(socket_path);
+    assert(client.has_value());
+    auto results = client->Validate({valid, invalid, valid, dir + "daemon_missing.txt"});
+    assert(results.has_value() && results->size() == 4);
+    assert((*results)[0].has_value() && (*results)[0]->final_result_code == call_pipeline(valid)->final_result_code);
+    assert(std::get<ValidationError>((*results)[1].error()).field_name == "invalid_field");
+    assert((*results)[2].has_value());
+    assert(std::holds_alternative<ConfigReadError>((*results)[3].error()));
+
+    // A batch whose replies exceed the daemon's output cap still completes.
+    {
+        std::string reply;
+        ResultRenderer::append_binary(reply, call_pipeline(invalid));
+        const std::size_t count = 2 * kMaxDaemonPendingOutput / reply.size() + 1;
+        auto large = client->Validate(std::vector<std::string>(count, invalid));
+        assert(large.has_value() && large->size() == count);
+        assert(std::ranges::none_of(*large, [](const auto& r) { return r.has_value(); }));
+    }
+
+    // A client speaking another protocol version is disconnected.
+    {
+        const sockaddr_un addr = unix_socket_address(socket_path);
+        const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        const int connected = ::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr));
+        assert(fd >= 0 && connected == 0);
+        std::string version;
+        append_u32_le(version, kDaemonProtocolVersion - 1);
+        std::string hello;
+        append_daemon_message(hello, kDaemonHelloId, version);
+        const ssize_t written = ::write(fd, hello.data(), hello.size());
+        assert(written == static_cast<ssize_t>(hello.size()));
+        char reply[64];
+        const ssize_t answered = ::read(fd, reply, sizeof(reply));
+        assert(answered == 0);
+        ::close(fd);
+    }
+
+    // A client that half-closes after sending still gets every answer.
+    {
+        const sockaddr_un addr = unix_socket_address(socket_path);
+        const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        const int connected = ::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr));
+        assert(fd >= 0 && connected == 0);
+        std::string version;
+        append_u32_le(version, kDaemonProtocolVersion);
+        std::string request;
+        append_daemon_message(request, kDaemonHelloId, version);
+        append_daemon_message(request, 7, valid);
+        append_daemon_message(request, 8, invalid);
+        const ssize_t written = ::write(fd, request.data(), request.size());
+        const int shut = ::shutdown(fd, SHUT_WR);
+        assert(written == static_cast<ssize_t>(request.size()) && shut == 0);
+        std::string reply;
+        char chunk[4096];
+        for (ssize_t n; (n = ::read(fd, chunk, sizeof(chunk))) > 0;) {
+            reply.append(chunk, static_cast<std::size_t>(n));
+        }
+        ::close(fd);
+        std::string_view in = reply;
+        std::uint32_t id = 0;
+        std::string_view body;
+        assert(next_daemon_message(in, id, body) == FrameStatus::Complete && id == kDaemonHelloId);
+        assert(next_daemon_message(in, id, body) == FrameStatus::Complete && id == 7);
+        assert(decode_binary_result(body)->has_value());
+        assert(next_daemon_message(in, id, body) == FrameStatus::Complete && id == 8);
+        assert(!decode_binary_result(body)->has_value());
+        assert(in.empty());
+    }
+
+    // A client that never reads its answers is throttled: once its output
+    // backlog reaches the cap the daemon stops reading, so its writes block.
+    {
+        const sockaddr_un addr = unix_socket_address(socket_path);
+        const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        const int connected = ::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr));
+        assert(fd >= 0 && connected == 0);
+        std::string version;
+        append_u32_le(version, kDaemonProtocolVersion);
+        std::string hello;
+        append_daemon_message(hello, kDaemonHelloId, version);
+        const ssize_t greeted = ::write(fd, hello.data(), hello.size());
+        assert(greeted == static_cast<ssize_t>(hello.size()));
+        std::string requests;
+        while (requests.size() < 256 * 1024) {
+            append_daemon_message(requests, 1, invalid);
+        }
+        std::size_t written = 0;
+        int stalls = 0;
+        for (std::size_t offset = 0; stalls < 20 && written < 64 * kMaxDaemonPendingOutput;) {
+            const ssize_t n = ::write(fd, requests.data() + offset, requests.size() - offset);
+            if (n < 0) {
+                assert(errno == EAGAIN);
+                ++stalls;
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                continue;
+            }
+            stalls = 0;
+            written += static_cast<std::size_t>(n);
+            offset = (offset + static_cast<std::size_t>(n)) % requests.size();
+        }
+        assert(stalls == 20);
+        ::close(fd);
+    }
+
+    const auto report = run_daemon_load_test(socket_path, {valid, invalid}, 2, std::chrono::milliseconds(50), 4);
+    assert(report.failures == 0 && report.requests > 0 && report.p99_us >= report.p50_us && report.p50_us > 0);
+
+    stop.request_stop();
+    server.join();
+    // Repeated paths within a batch ran once.
+    assert(daemon->stats().requests >= 4 + 2 + report.requests && daemon->stats().pipeline_runs < daemon->stats().requests);
+    assert(std::filesystem::exists(cache_path));
+    daemon = std::unexpected(ConfigReadError{"closed"});
+    assert(!std::filesystem::exists(socket_path));
+    g_debug_logging.store(true, std::memory_order_relaxed);
+
+    std::remove(valid.c_str());
+    std::remove(invalid.c_str());
+    std::remove(cache_path.c_str());
+    std::cout << "test_validation_daemon() passes" << std::endl;
+}
+
+void test_shared_result_board() {
+    const std::string name = "/pipeline_board_test_" + std::to_string(::getpid());
+    auto publisher = ResultBoard::Create(name, 4);
+    assert(publisher.has_value());
+    auto reader = ResultBoard::Open(name);
+    assert(reader.has_value() && reader->capacity() == publisher->capacity());
+
+    const bool published_a = publisher->Publish("a.conf", Result{29});
+    const bool published_b =
+        publisher->Publish("b.conf", std::unexpected(ValidationError{"invalid_field", "contains disallowed value", 11}));
+    assert(published_a && published_b);
+    assert(reader->Lookup("a.conf")->value().final_result_code == 29);
+    const auto b = reader->Lookup("b.conf");
+    assert(b && std::get<ValidationError>(b->error()).offset == 11);
+    assert(!reader->Lookup("c.conf").has_value());
+    const bool published_by_reader = reader->Publish("c.conf", Result{1});
+    const bool published_long_path = publisher->Publish(std::string(kBoardPathBytes + 1, 'p'), Result{1});
+    assert(!published_by_reader && !published_long_path);
+
+    // Readers never see a half-written record while the publisher rewrites it.
+    std::atomic<bool> done{false};
+    std::jthread writer([&] {
+        for (int i = 0; i < 200000; ++i) {
+            (void)(i % 2 == 0 ? publisher->Publish("a.conf", Result{1000})
+                              : publisher->Publish("a.conf", std::unexpected(ProcessingError{"ProcessData", "too short"})));
+        }
+        done = true;
+    });
+    std::uint64_t reads = 0;
+    while (!done) {
+        const auto seen = reader->Lookup("a.conf");
+        assert(seen.has_value());
+        assert(seen->has_value() ? seen->value().final_result_code == 1000 || seen->value().final_result_code == 29
+                                 : std::get<ProcessingError>(seen->error()).details == "too short");
+        ++reads;
+    }
+    writer.join();
+    assert(reads > 0);
+
+    // A publisher that dies mid-write leaves its slot odd; readers miss
+    // instead of spinning forever.
+    {
+        const int fd = ::shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0);
+        assert(fd >= 0);
+        const std::size_t size = sizeof(BoardHeader) + publisher->capacity() * sizeof(BoardSlot);
+        void* addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        assert(addr != MAP_FAILED);
+        auto* slots = reinterpret_cast<BoardSlot*>(static_cast<char*>(addr) + sizeof(BoardHeader));
+        const auto found = std::find_if(slots, slots + publisher->capacity(), [](const BoardSlot& slot) {
+            return std::string_view(slot.path, slot.path_size) == "b.conf";
+        });
+        assert(found != slots + publisher->capacity());
+        BoardSlot& stuck = *found;
+        stuck.sequence.fetch_add(1);
+        assert(!reader->Lookup("b.conf").has_value());
+        stuck.sequence.fetch_add(1);
+        assert(reader->Lookup("b.conf").has_value());
+        ::munmap(addr, size);
+    }
+
+    // Re-creating the board leaves existing readers on the old segment.
+    auto replacement = ResultBoard::Create(name, 4);
+    assert(replacement.has_value());
+    assert(reader->Lookup("b.conf").has_value());
+    const auto reopened = ResultBoard::Open(name);
+    assert(reopened.has_value() && !reopened->Lookup("b.conf").has_value());
+
+    ResultBoard::Remove(name);
+    const auto removed = ResultBoard::Open(name);
+    assert(!removed.has_value());
+    std::cout << "test_shared_result_board() passes" << std::endl;
+}
+
+void test_perf_counters() {
+    PerfCounters counters;
+    const std::string status = counters.status();
+    assert(counters.available() ? status == "available" : status.starts_with("unavailable: "));
+    counters.start();
+    volatile std::uint64_t sink = 0;
+    for (int i = 0; i < 100000; ++i) {
+        sink = sink + static_cast<std::uint64_t>(i);
+    }
+    const PerfCounters::Counts counts = counters.stop();
+    assert(counters.available() || std::none_of(counts.begin(), counts.end(), [](const auto& c) { return c.has_value(); }));
+    if (counts[1]) {
+        assert(*counts[1] > 100000.0); // instructions
+    }
+
+    // Unavailable counters are left out of the JSON rather than reported as 0.
+    BenchmarkResult result{"example", 1, 2.0, 0.0, {}};
+    result.counters_per_op[0] = 3.0;
+    std::ostringstream json;
+    print_benchmarks_json({result}, json);
+    assert(json.str().find("\"perf_counters\":\"") != std::string::npos);
+    assert(json.str().find("\"counters\":{\"cycles\":3}") != std::string::npos);
+    result.counters_per_op[0].reset();
+    std::ostringstream bare;
+    print_benchmarks_json({result}, bare);
+    assert(bare.str().find("\"counters\"") == std::string::npos);
+    assert(bare.str().find("\"mb_per_s\":0}") != std::string::npos);
+    std::cout << "test_perf_counters() passes" << std::endl;
+}
+
+void test_failure_streams() {
+    const auto count = [](const std::vector<std::uint8_t>& stream) {
+        return static_cast<std::size_t>(std::count(stream.begin(), stream.end(), std::uint8_t{1}));
+    };
+    const auto deterministic = make_failure_stream(FailurePattern::Deterministic, 0.25, 1000);
+    assert(count(deterministic) == 250);
+    assert(deterministic[249] == 1 && deterministic[250] == 0);
+
+    const auto periodic = make_failure_stream(FailurePattern::Periodic, 0.1, 1000);
+    assert(count(periodic) == 100);
+    for (std::size_t i = 0; i < periodic.size(); ++i) {
+        assert(periodic[i] == (i % 10 == 0));
+    }
+
+    const auto random = make_failure_stream(FailurePattern::Random, 0.5, 1 << 16);
+    assert(count(random) > 31000 && count(random) < 34500);
+    assert(random == make_failure_stream(FailurePattern::Random, 0.5, 1 << 16)); // reproducible
+    assert(count(make_failure_stream(FailurePattern::Random, 0.0, 1000)) == 0);
+    assert(count(make_failure_stream(FailurePattern::Periodic, 1.0, 1000)) == 1000);
+    assert(count(make_failure_stream(FailurePattern::Periodic, 0.0, 1000)) == 0);
+    std::cout << "test_failure_streams() passes" << std::endl;
+}
+
+void test_error_domains() {
+    const PipelineError errors[] = {
+        ConfigReadError{"a.conf"},
+        ConfigParseError{"malformed", 1},
+        ValidationError{"invalid_field", "x", 3},
+        ProcessingError{"Data Processing", "Input data too short for task"},
+        OutOfMemoryError{"LoadConfig", 64},
+        Cancelled{"ValidateData"},
+        DeadlineExceeded{"ProcessData", std::chrono::milliseconds(1), std::chrono::microseconds(5), false},
+    };
+    static_assert(std::size(errors) == std::variant_size_v<PipelineError>);
+    for (const PipelineError& error : errors) {
+        const std::error_code code = make_error_code(error);
+        assert(code); // non-zero: an error_code of 0 means success
+        assert(code.category() == pipeline_error_category());
+        assert(code.value() == error_traits(error).code);
+        assert(code.message() == error_kind_name(error));
+        assert(error_kind(error) == static_cast<PipelineErrorKind>(error.index()));
+        assert(is_cacheable(std::unexpected(error)) == error_traits(error).deterministic);
+    }
+    // The codes are part of the wire contract and must not change: they are
+    // the tag byte of binary records in the cache, daemon and board formats.
+    static_assert(error_traits(PipelineErrorKind::ConfigRead).code == 1);
+    static_assert(error_traits(PipelineErrorKind::DeadlineExceeded).code == 7);
+    constexpr unsigned char kWireTags[] = {1, 2, 3, 4, 5, 6, 7};
+    for (std::size_t i = 0; i < std::size(errors); ++i) {
+        std::string record;
+        ResultRenderer::append_binary(record, std::unexpected(errors[i]));
+        assert(static_cast<unsigned char>(record[0]) == kWireTags[i]);
+        std::string_view in = record;
+        assert(error_kind(decode_binary_result(in)->error()) == error_kind(errors[i]));
+    }
+    std::string record;
+    ResultRenderer::append_binary(record, Result{1});
+    assert(record[0] == 0);
+    record[0] = static_cast<char>(200); // no such code
+    std::string_view unknown = record;
+    assert(!decode_binary_result(unknown));
+    static_assert(!error_traits(PipelineErrorKind::Validation).retryable);
+    assert(is_retryable(errors[6]) && is_retryable(errors[0]) && !is_retryable(errors[5]));
+
+    // PipelineErrorKind converts to std::error_code and compares with std::errc.
+    std::error_code code = PipelineErrorKind::Cancelled;
+    assert(code == std::errc::operation_canceled);
+    assert(std::strcmp(code.category().name(), "pipeline") == 0);
+    assert(make_error_code(errors[6]) == std::errc::timed_out);
+    assert(make_error_code(errors[4]) == std::errc::not_enough_memory);
+    assert(make_error_code(errors[1]) != std::errc::invalid_argument);
+    assert(make_error_code(errors[1]).default_error_condition().category() == pipeline_error_category());
+    assert(pipeline_error_category().message(999) == "unknown pipeline error");
+
+    // Other domains stay distinct.
+    assert(make_error_code(PipelineErrorKind::ConfigRead) != std::error_code(1, std::generic_category()));
+    std::cout << "test_error_domains() passes" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    // Benchmark mode: ./a.out --bench [suite]
+    if (argc >= 2 && std::string_view(argv[1]) == "--bench") {
+        return run_benchmarks(argc >= 3 ? argv[2] : "");
+    }
+
+    // Compile mode: ./a.out --compile <image> <config>...
+    if (argc >= 3 && std::string_view(argv[1]) == "--compile") {
+        auto compiled = CompileConfigImage(std::vector<std::string>(argv + 3, argv + argc), argv[2]);
+        if (!compiled) {
+            std::cerr << "Compiling config image failed: ";
+            print_pipeline_error(compiled.error(), std::cerr);
+            return 1;
+        }
+        std::cout << "Wrote config image " << argv[2] << std::endl;
+        return 0;
+    }
+
+    // Daemon mode: ./a.out --daemon <socket> <cache>, stopped by SIGINT or SIGTERM
+    if (argc >= 4 && std::string_view(argv[1]) == "--daemon") {
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+        auto daemon = ValidationDaemon::Listen(argv[2], argv[3]);
+        if (!daemon) {
+            std::cerr << "Starting the daemon failed: ";
+            print_pipeline_error(daemon.error(), std::cerr);
+            return 1;
+        }
+        g_debug_logging.store(false, std::memory_order_relaxed);
+        std::stop_source stop;
+        std::jthread signal_waiter([&signals, &stop] {
+            int signal = 0;
+            sigwait(&signals, &signal);
+            stop.request_stop();
+        });
+        daemon->Run(stop.get_token());
+        return 0;
+    }
+
+    // Load test: ./a.out --load-test <socket> <milliseconds> <connections> <config>...
+    if (argc >= 6 && std::string_view(argv[1]) == "--load-test") {
+        const auto report = run_daemon_load_test(argv[2], std::vector<std::string>(argv + 5, argv + argc),
+                                                 static_cast<unsigned>(std::max(1, std::atoi(argv[4]))),
+                                                 std::chrono::milliseconds(std::atoi(argv[3])));
+        print_load_test_json(report, std::cout);
+        return report.failures == 0 ? 0 : 1;
+    }
+
+    // Publish mode: ./a.out --publish </board-name> <config>...
+    if (argc >= 4 && std::string_view(argv[1]) == "--publish") {
+        auto board = ResultBoard::Create(argv[2], static_cast<std::size_t>(argc - 3));
+        if (!board) {
+            std::cerr << "Creating the result board failed: ";
+            print_pipeline_error(board.error(), std::cerr);
+            return 1;
+        }
+        g_debug_logging.store(false, std::memory_order_relaxed);
+        int published = 0;
+        for (int i = 3; i < argc; ++i) {
+            published += board->Publish(argv[i], call_pipeline(argv[i])) ? 1 : 0;
+        }
+        std::cout << "Published " << published << " result(s) to " << argv[2] << std::endl;
+        return published == argc - 3 ? 0 : 1;
+    }
+
     // Scenario 1: Successful pipeline execution
     std::cout << "--- Scenario 1: Successful Execution ---" << std::endl;
     // Create a dummy file for successful config load
@@ -205,7 +5936,37 @@ int main() {
     // Conduct unit tests
     std::cout << "\n--- Start unit testing. ---" << std::endl;
     test_read_nonexisted_config_file();
+    test_stack_capture_sampling();
+    test_error_reporter_aggregates_storm();
+    test_pipelined_matches_sequential();
+    test_config_image_roundtrip_and_fallback();
+    test_parallel_scan_matches_sequential();
+    test_batch_error_deduplication();
+    test_result_renderer_formats();
+    test_in_memory_pipeline_and_fuzz_limits();
+    test_pipeline_allocation_budgets();
+#if defined(PIPELINE_TESTING)
+    test_allocation_failure_is_reported();
+#endif
+    test_constexpr_stages_match_runtime();
+#if defined(PIPELINE_EMBED_CONFIG) || defined(PIPELINE_EMBED_CONFIG_BYTES)
+    test_embedded_config_matches_text_path();
+#endif
+    test_pattern_rule_engine();
+    test_compile_time_regex_rules();
+    test_schema_extraction();
+    test_inline_error_strings();
+    test_error_context_chain();
+    test_cancellation();
+    test_deadlines();
+    test_persistent_result_cache();
+    test_validation_daemon();
+    test_shared_result_board();
+    test_perf_counters();
+    test_failure_streams();
+    test_error_domains();
     std::cout << "\n--- All unit tests pass. ---" << std::endl;
 
     return 0;
 }
+#endif